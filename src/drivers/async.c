@@ -35,7 +35,9 @@
 #include <linux/proc_fs.h>
 #include <linux/miscdevice.h>
 #include <linux/debugfs.h>
-#include <linux/mm.h>  // mmap related stuff#include <linux/slab.h>#include <linux/types.h>
+#include <linux/mm.h>  // mmap related stuff
+#include <linux/slab.h>
+#include <linux/types.h>
 #include <linux/wait.h>
 #include <linux/sched.h>
 #include <linux/poll.h>
@@ -44,6 +46,9 @@
 #include <linux/delay.h>
 #include <linux/kthread.h>  // for threads
 #include <linux/string.h>
+#include <linux/pci.h>
+#include <linux/slab.h>
+#include <linux/async_minit_order.h>
 
 /*
  * Why do I did this?
@@ -57,9 +62,8 @@
 #define grp_none_nfo                   disable
 #define grp_hid_nfo                    disable
 #define grp_dma_nfo                    disable
-#define grp_char_nfo                   disable
-#define grp_none_nfo                   disable
 #define grp_usb_nfo                    disable
+#define grp_none_nfo                   disable
 #define grp_ssb_nfo                    disable
 #define grp_snd_hda_nfo                disable
 #define intel_cqm_init_nfo             disable
@@ -77,7 +81,7 @@
 #define b43_pcmcia_init_nfo            deferred,grp_none,grp_pcmcia
 #define ssb_hcd_init_nfo               deferred,grp_none,grp_ssb
 
-#define ahci_pci_driver_init_nfo       asynchronized   /* ahci.ko */
+#define ahci_pci_driver_init_nfo       critical        /* ahci.ko */
 #define ahci_driver_init_nfo           asynchronized,grp_none,ahci_pci_driver_init  /**/
 #define fbmem_init_nfo                 asynchronized    /* drivers/video/fbdev/core/fbmem.c */
 #define mda_console_init_nfo           asynchronized,grp_none,fbmem_init    /* drivers/video/console/mdacon.c */
@@ -93,14 +97,14 @@
 #define cn_proc_init_nfo               asynchronized   /* connector/cn_proc.c */
 #define configfs_init_nfo              asynchronized   /* fs/configfs/mount.c  */
 #define coretemp_init_nfo              asynchronized   /* drivers/hwmon/coretemp.c  */
-#define crc_t10dif_mod_init_nfo        asynchronized   /* lib/crc-t10dif.c   */
+#define crc_t10dif_mod_init_nfo        critical        /* lib/crc-t10dif.c  sd integrity */
 #define acpi_video_init_nfo            asynchronized   /* drivers/acpi/video.ko */
 #define cubictcp_register_nfo          asynchronized   /* net/ipv4/tcp_cubic.c   */
 #define dio_init_nfo                   asynchronized   /*  fs/direct-io.c  */
 #define dnotify_init_nfo               asynchronized   /* /fs/notify/dnotify/dnotify.c  */
 #define drm_core_init_nfo              asynchronized,grp_none,agp_init   /* drm.ko */
 #define evdev_init_nfo                 asynchronized   /*  drivers/input/evdev.c  */
-#define ext4_init_fs_nfo                asynchronized,grp_none,init_hugetlbfs_fs   /* fs/ext4/super.c  */
+#define ext4_init_fs_nfo                critical,grp_none,init_hugetlbfs_fs,init_mbcache   /* fs/ext4/super.c  */
 #define extfrag_debug_init_nfo         asynchronized   /* mm/vmstat.c  */
 #define fcntl_init_nfo                 asynchronized   /**/
 #define i2c_dev_init_nfo                asynchronized   /* /drivers/i2c/i2c-dev.c */
@@ -110,7 +114,7 @@
 #define ikconfig_init_nfo               asynchronized   /* kernel/configs.c */
 #define init_devpts_fs_nfo              asynchronized   /* fs/devpts/inode.c  */
 #define init_hugetlbfs_fs_nfo           asynchronized   /* /fs/hugetlbfs/inode.c  */
-#define init_mbcache_nfo                asynchronized   /* /fs/mbcache.c  */
+#define init_mbcache_nfo                critical        /* /fs/mbcache.c  */
 #define deadline_init_nfo               asynchronized   /* /block/deadline-iosched.c */
 #define init_nls_ascii_nfo              asynchronized   /* fs/nls/nls_ascii.c  */
 #define init_nls_cp437_nfo              asynchronized   /* fs/nls/nls_cp437.c  */
@@ -119,7 +123,7 @@
 #define init_nls_iso8859_1_nfo          asynchronized   /*  fs/nls/nls_iso8859-1.c  */
 #define init_nls_utf8_nfo               asynchronized   /* fs/nls/nls_utf8.c */
 #define init_per_zone_wmark_min_nfo     asynchronized   /* mm/page_alloc.c */
-#define init_sd_nfo                     asynchronized   /* /drivers/scsi/sd.c   */
+#define init_sd_nfo                     critical        /* /drivers/scsi/sd.c   */
 #define init_sg_nfo                     asynchronized   /* /drivers/scsi/sg.c   */
 #define init_nfo                           asynchronized   /**/
 #define inotify_user_setup_nfo             asynchronized   /*  fs/notify/inotify/inotify_user.c  */
@@ -130,7 +134,7 @@
 #define proc_locks_init_nfo                asynchronized   /* fs/locks.c  */
 #define proc_modules_init_nfo              asynchronized   /**/
 #define proc_vmalloc_init_nfo              asynchronized   /* /mm/vmalloc.c  */
-#define libcrc32c_mod_init_nfo             asynchronized   /* lib/libcrc32c.c  */
+#define libcrc32c_mod_init_nfo             critical        /* lib/libcrc32c.c  ext4 checksums */
 #define nvidia_frontend_init_module_nfo    asynchronized,grp_none,drm_core_init /* nvidia.ko */
 #define nvram_init_nfo                     asynchronized,grp_none,pty_init   /* drivers/char/nvram.c */
 #define percpu_counter_startup_nfo         asynchronized   /*  lib/percpu_counter.c  */
@@ -145,22 +149,22 @@
 #define sock_diag_init_nfo                 asynchronized   /* /net/core/sock_diag.c  */
 
 //Sound
-#define generic_driver_init_nfo           deferred,grp_none,grp_snd_hda  /*/sound/pci/hda/hda_generic.c*/
-#define realtek_driver_init_nfo           deferred,grp_none,grp_snd_hda /*sound/pci/hda/patch_realtek.c */
-#define cmedia_driver_init_nfo            deferred,grp_none,grp_snd_hda  /* sound/pci/hda/patch_cmedia.c */
-#define analog_driver_init_nfo            deferred,grp_none,grp_snd_hda  /* sound/pci/hda/patch_analog.c */
-#define sigmatel_driver_init_nfo          deferred,grp_none,grp_snd_hda /* sound/pci/hda/patch_sigmatel.c   */
-#define si3054_driver_init_id_nfo         deferred,grp_none,grp_snd_hda /* sound/pci/hda/patch_si3054.c  */
-#define cirrus_driver_init_nfo            deferred,grp_none,grp_snd_hda /*sound/pci/hda/patch_cirrus.c */
-#define cirrus_driver_init_nfo            deferred,grp_none,grp_snd_hda /* sound/pci/hda/patch_cirrus.c */
-#define ca0110_driver_init_nfo            deferred,grp_none,grp_snd_hda /* sound/pci/hda/patch_ca0110.c */
-#define ca0132_driver_init_nfo            deferred,grp_none,grp_snd_hda  /* sound/pci/hda/patch_ca0132.c */
-#define conexant_driver_init_nfo          deferred,grp_none,grp_snd_hda  /* sound/pci/hda/patch_conexant.c */
-#define via_driver_init_nfo               deferred,grp_none,grp_snd_hda  /* sound/pci/hda/patch_via.c  */
-#define hdmi_driver_init_nfo              deferred,grp_none,grp_snd_hda  /* sound/pci/hda/patch_hdmi.c  */
-#define si3054_driver_init_nfo            deferred,grp_none,grp_snd_hda
-
-#define a4_driver_init_nfo                deferred,grp_none,hid_init,uhid_init  /**/
+#define generic_driver_init_nfo           deferred,grp_snd_hda,alsa_hwdep_init,alsa_pcm_init  /*/sound/pci/hda/hda_generic.c*/
+#define realtek_driver_init_nfo           deferred,grp_snd_hda,alsa_hwdep_init,alsa_pcm_init /*sound/pci/hda/patch_realtek.c */
+#define cmedia_driver_init_nfo            deferred,grp_snd_hda,alsa_hwdep_init,alsa_pcm_init  /* sound/pci/hda/patch_cmedia.c */
+#define analog_driver_init_nfo            deferred,grp_snd_hda,alsa_hwdep_init,alsa_pcm_init  /* sound/pci/hda/patch_analog.c */
+#define sigmatel_driver_init_nfo          deferred,grp_snd_hda,alsa_hwdep_init,alsa_pcm_init /* sound/pci/hda/patch_sigmatel.c   */
+#define si3054_driver_init_id_nfo         deferred,grp_snd_hda,alsa_hwdep_init,alsa_pcm_init /* sound/pci/hda/patch_si3054.c  */
+#define cirrus_driver_init_nfo            deferred,grp_snd_hda,alsa_hwdep_init,alsa_pcm_init /*sound/pci/hda/patch_cirrus.c */
+#define cirrus_driver_init_nfo            deferred,grp_snd_hda,alsa_hwdep_init,alsa_pcm_init /* sound/pci/hda/patch_cirrus.c */
+#define ca0110_driver_init_nfo            deferred,grp_snd_hda,alsa_hwdep_init,alsa_pcm_init /* sound/pci/hda/patch_ca0110.c */
+#define ca0132_driver_init_nfo            deferred,grp_snd_hda,alsa_hwdep_init,alsa_pcm_init  /* sound/pci/hda/patch_ca0132.c */
+#define conexant_driver_init_nfo          deferred,grp_snd_hda,alsa_hwdep_init,alsa_pcm_init  /* sound/pci/hda/patch_conexant.c */
+#define via_driver_init_nfo               deferred,grp_snd_hda,alsa_hwdep_init,alsa_pcm_init  /* sound/pci/hda/patch_via.c  */
+#define hdmi_driver_init_nfo              deferred,grp_snd_hda,alsa_hwdep_init,alsa_pcm_init  /* sound/pci/hda/patch_hdmi.c  */
+#define si3054_driver_init_nfo            deferred,grp_snd_hda,alsa_hwdep_init,alsa_pcm_init
+
+#define a4_driver_init_nfo                deferred,grp_hid,hid_init  /**/
 #define acpi_battery_init_nfo             deferred /**/
 #define acpi_button_driver_init_nfo       deferred  /* */
 #define acpi_fan_driver_init_nfo          deferred // asynchronized   /**/
@@ -194,7 +198,7 @@
 #define alsa_sound_last_init_nfo            disable  /* sound/core/last.c */
 #define alsa_timer_init_nfo                 deferred         /* snd-timer.ko */
 #define anubis_mod_init_nfo                 deferred   /**/
-#define apple_driver_init_nfo               deferred,grp_none,hid_init,uhid_init  /**/
+#define apple_driver_init_nfo               deferred,grp_hid,hid_init  /**/
 #define arc4_init_nfo                       deferred   /**/
 #define asymmetric_key_init_nfo             deferred  /**/
 #define async_pq_init_nfo                   deferred   /**/
@@ -202,17 +206,17 @@
 #define atlas_acpi_driver_nfo               deferred,grp_none,acpi_ac_init                /* */
 #define azx_driver_init_nfo                 deferred  /**/
 
-#define belkin_driver_init_nfo              deferred,grp_none,hid_init,uhid_init  /**/
+#define belkin_driver_init_nfo              deferred,grp_hid,hid_init  /**/
 #define blowfish_mod_init_nfo               deferred   /* blowfish_generic.ko */
 #define brd_init_nfo                         deferred  /**/
 #define camellia_init_nfo                   deferred   /**/
 #define cast5_mod_init_nfo                  deferred   /* cat5_generic.ko */
 #define cast6_mod_init_nfo                  deferred   /* cast6_generic.ko */
 #define chainiv_module_init_nfo              deferred   /**/
-#define cherry_driver_init_nfo              deferred,grp_none,hid_init,uhid_init   /**/
-#define chicony_driver_init_nfo              deferred,grp_none,hid_init,uhid_init  /**/
+#define cherry_driver_init_nfo              deferred,grp_hid,hid_init   /**/
+#define chicony_driver_init_nfo              deferred,grp_hid,hid_init  /**/
 #define coretemp_nfo                         deferred   /* coretemp.ko */
-#define cp_driver_init_nfo                     deferred,grp_none,hid_init,uhid_init  /**/
+#define cp_driver_init_nfo                     deferred,grp_hid,hid_init  /**/
 #define cpufreq_gov_dbs_init_nfo               deferred  /**/
 #define cpufreq_gov_powersave_init_nfo          deferred  /**/
 #define cpufreq_gov_userspace_init_nfo          deferred  /**/
@@ -240,13 +244,13 @@
 #define deflate_mod_init_nfo                 deferred   /**/
 #define des_generic_mod_init_nfo           deferred   /**/
 #define drm_fb_helper_modinit_nfo          deferred    /* */
-#define ehci_hcd_init_nfo                  deferred   /* ehci-hcd.ko */
-#define ehci_pci_init_nfo                  deferred,grp_none,ehci_hcd_init   /* ehci-pci.ko */
-#define ehci_platform_init_nfo             deferred,grp_none,ehci_hcd_init   /* ehci-platform.ko */
-#define elo_driver_init_nfo                deferred   /* usbhid.ko */
+#define ehci_hcd_init_nfo                  deferred,grp_usb   /* ehci-hcd.ko */
+#define ehci_pci_init_nfo                  deferred,grp_usb,ehci_hcd_init   /* ehci-pci.ko */
+#define ehci_platform_init_nfo             deferred,grp_usb,ehci_hcd_init   /* ehci-platform.ko */
+#define elo_driver_init_nfo                deferred,grp_hid   /* usbhid.ko */
 #define ene_ub6250_driver_init_nfo        deferred,grp_none,usb_storage_driver_init   /* ums-eneub6250.ko */
 #define eseqiv_module_init_nfo            deferred   /**/
-#define ez_driver_init_nfo                deferred,grp_none,hid_init,uhid_init  /**/
+#define ez_driver_init_nfo                deferred,grp_hid,hid_init  /**/
 #define fcrypt_mod_init_nfo               deferred   /**/
 #define forcedeth_pci_driver_init_nfo     deferred  /* */
 #define fuse_init_nfo                    deferred   /* fuse.ko */
@@ -255,14 +259,14 @@
 #define gpio_fan_nfo                     deferred   /* gpio-fan.ko */
 #define gspca_init_nfo                   deferred   /*  /drivers/media/usb/gspca/gspca.c */
 #define gspca_main_nfo                   deferred   /* gspca_main.ko */
-#define hid_generic_init_nfo             deferred,grp_none,hid_init,uhid_init  /**/
-#define hid_generic_nfo                   deferred,grp_none,hid_init,uhid_init  /**/
-#define hid_init_nfo                      deferred,grp_none,ohci_platform_init        /**/
+#define hid_generic_init_nfo             deferred,grp_hid,hid_init  /**/
+#define hid_generic_nfo                   deferred,grp_hid,hid_init  /**/
+#define hid_init_nfo                      deferred,grp_hid,ohci_platform_init        /**/
 #define hilscher_pci_driver_init_nfo      deferred,grp_none,uio_init   /* uio_cif.ko */
 #define hmac_module_init_nfo              deferred   /**/
 #define hpet_init_nfo                     deferred  /**/
 #define hwrng_modinit_nfo                 deferred   /* rng-core.ko */
-#define i2c_hid_driver_init_nfo           deferred  /**/
+#define i2c_hid_driver_init_nfo           deferred,grp_hid  /**/
 #define i2c_mux_gpio_driver_nfo           deferred   /* i2c-mux-gpio.ko module_platform_driver */
 #define i8042_init_nfo                    deferred  /**/
 #define init_autofs4_fs_nfo               deferred   /*  /fs/autofs4/init.c  */
@@ -284,15 +288,15 @@
 #define irst_driver_nfo                 deferred,grp_none,acpi_ac_init                /* */
 #define ismt_driver_init_nfo            deferred //asynchronized   /* drivers/i2c/busses/i2c-ismt.c */
 #define journal_init_nfo                deferred   /* jbd.ko */
-#define keytouch_driver_init_nfo        deferred,grp_none,hid_init,uhid_init  /**/
+#define keytouch_driver_init_nfo        deferred,grp_hid,hid_init  /**/
 #define khazad_mod_init_nfo             deferred   /**/
 #define krng_mod_init_nfo               deferred   /**/
-#define ks_driver_init_nfo              deferred,grp_none,hid_init,uhid_init  /**/
+#define ks_driver_init_nfo              deferred,grp_hid,hid_init  /**/
 #define kswapd_init_nfo                 asynchronized   /**/
 #define led_class_nfo                   deferred   /* led-class.ko */
 #define led_driver_init_nfo             deferred      /* usbled.ko */
 #define leds_pca955x_nfo                deferred   /* leds-pca955x.ko */
-#define lg_driver_init_nfo              deferred,grp_none,hid_init,uhid_init  /**/
+#define lg_driver_init_nfo              deferred,grp_hid,hid_init,usb_hid_init  /**/
 #define lib80211_crypto_ccmp_init_nfo    deferred,grp_none,lib80211_init   /* lib80211_crypt_ccmp.ko */
 #define lib80211_crypto_tkip_init_nfo    deferred,grp_none,lib80211_init   /* lib80211_crypt_tkip.ko */
 #define lib80211_crypto_wep_init_nfo    deferred,grp_none,lib80211_init   /* lib80211_crypt_wep.ko */
@@ -311,28 +315,28 @@
 #define mmc_blk_init_nfo               deferred   /* mmc_block.ko */
 #define mod_init_nfo                   deferred // asynchronized,grp_none,pty_init   /* /drivers/char/hw_random/intel-rng.c */
 #define mousedev_init_nfo              deferred  /**/
-#define mr_driver_init_nfo             deferred,grp_none,hid_init,uhid_init  /**/
-#define ms_driver_init_nfo             deferred,grp_none,hid_init,uhid_init  /**/
+#define mr_driver_init_nfo             deferred,grp_hid,hid_init  /**/
+#define ms_driver_init_nfo             deferred,grp_hid,hid_init  /**/
 #define mxm_wmi_init_nfo               deferred   /* mxm-wmi.ko */
 #define nforce2_driver_init_nfo        deferred  /* */
 #define nforce2_init_nfo               deferred  /* drivers/cpufreq/cpufreq-nforce2.c */
 #define noop_init_nfo                  deferred// asynchronized   /*  /block/noop-iosched.c  */
-#define ohci_hcd_mod_init_nfo          deferred,ehci_platform_init   /* ohci-hcd.ko */
-#define ohci_pci_init_nfo              deferred,ohci_hcd_mod_init,ehci_hcd_init   /* ohci-pci.ko */
-#define ohci_platform_init_nfo         deferred,ohci_hcd_mod_init   /* ohci-platform.ko */
+#define ohci_hcd_mod_init_nfo          deferred,grp_usb,ehci_platform_init   /* ohci-hcd.ko */
+#define ohci_pci_init_nfo              deferred,grp_usb,ohci_hcd_mod_init,ehci_hcd_init   /* ohci-pci.ko */
+#define ohci_platform_init_nfo         deferred,grp_usb,ohci_hcd_mod_init   /* ohci-platform.ko */
 #define oprofile_init_nfo              deferred // asynchronized     /* oprofile/oprof.c */
 #define packet_init_nfo                deferred // asynchronized   /* net/packet/af_packet.c   */
-#define patch_analog_init_nfo          deferred       /* snd-hda-codec-analog.ko */
-#define patch_ca0110_init_nfo          deferred       /* snd-hda-codec-ca0110.ko */
-#define patch_ca0132_init_nfo          deferred       /* snd-hda-codec-ca0132.ko */
-#define patch_cirrus_init_nfo          deferred       /* snd-hda-codec-cirrus.ko */
-#define patch_cmedia_init_nfo          deferred       /* snd-hda-codec-cmedia.ko */
-#define patch_conexant_init_nfo        deferred     /* snd-hda-codec-conexant.ko */
-#define patch_hdmi_init_nfo            deferred         /* snd-hda-codec-hdmi.ko */
-#define patch_realtek_init_nfo         deferred      /* snd-hda-codec-realtek.ko */
-#define patch_si3054_init_nfo          deferred       /* snd-hda-codec-si3054.ko */
-#define patch_sigmatel_init_nfo        deferred    /* snd-hda-codec-idt.ko */
-#define patch_via_init_nfo             deferred          /* snd-hda-codec-via.ko */
+#define patch_analog_init_nfo          deferred,grp_snd_hda       /* snd-hda-codec-analog.ko */
+#define patch_ca0110_init_nfo          deferred,grp_snd_hda       /* snd-hda-codec-ca0110.ko */
+#define patch_ca0132_init_nfo          deferred,grp_snd_hda       /* snd-hda-codec-ca0132.ko */
+#define patch_cirrus_init_nfo          deferred,grp_snd_hda       /* snd-hda-codec-cirrus.ko */
+#define patch_cmedia_init_nfo          deferred,grp_snd_hda       /* snd-hda-codec-cmedia.ko */
+#define patch_conexant_init_nfo        deferred,grp_snd_hda     /* snd-hda-codec-conexant.ko */
+#define patch_hdmi_init_nfo            deferred,grp_snd_hda         /* snd-hda-codec-hdmi.ko */
+#define patch_realtek_init_nfo         deferred,grp_snd_hda      /* snd-hda-codec-realtek.ko */
+#define patch_si3054_init_nfo          deferred,grp_snd_hda       /* snd-hda-codec-si3054.ko */
+#define patch_sigmatel_init_nfo        deferred,grp_snd_hda    /* snd-hda-codec-idt.ko */
+#define patch_via_init_nfo             deferred,grp_snd_hda          /* snd-hda-codec-via.ko */
 #define pca9541_driver_init_nfo        deferred  /**/
 #define pca9541_driver_nfo             deferred   /* i2c-mux-pca9541.ko module_i2c_driver */
 #define pca954x_driver_init_nfo        deferred  /**/
@@ -344,7 +348,7 @@
 #define pcied_init_nfo                  deferred,grp_none,pci_hotplug_init  /**/
 #define pcips2_driver_init_nfo         deferred // asynchronized  /* drivers/input/serio/pcips2.c */
 #define pkcs7_key_init_nfo             deferred  /**/
-#define plantronics_driver_init_nfo    deferred,grp_none,hid_init,uhid_init  /**/
+#define plantronics_driver_init_nfo    deferred,grp_hid,hid_init  /**/
 #define prgn_mod_init_nfo             deferred  /**/
 #define prng_mod_init_nfo             deferred  /* */
 #define psmouse_init_nfo              deferred  /**/
@@ -393,11 +397,11 @@
 #define twofish_mod_init_nfo           deferred  /**/
 #define uas_driver_init_nfo            deferred,grp_none,usb_storage_driver_init   /* uas.ko */
 #define ubi_init_nfo                   deferred,grp_none,init_mtd   /* ubi.ko */
-#define uhci_hcd_init_nfo              deferred,grp_none,ehci_hcd_init     /* uhci-hcd.ko */
-#define uhid_init_nfo                  deferred,grp_none,ohci_platform_init        /* uhid.ko */
+#define uhci_hcd_init_nfo              deferred,grp_usb,ehci_hcd_init     /* uhci-hcd.ko */
+#define uhid_init_nfo                  deferred,grp_hid,ohci_platform_init        /* uhid.ko */
 #define uinput_init_nfo                deferred  /**/
 #define uio_init_nfo                   deferred   /* uio.ko */
-#define usb_hid_init_nfo               deferred   /* usbhid.ko */
+#define usb_hid_init_nfo               deferred,grp_hid,hid_init   /* usbhid.ko */
 #define usb_storage_driver_init_nfo    deferred      /* usb-storage.ko */
 #define usblp_driver_init_nfo          deferred     /*   */
 #define usbmon_nfo                     deferred      /* usbmon.ko */
@@ -413,6 +417,109 @@
 #define pcspkr_platform_driver_init_nfo     deferred
 #define deinterlace_pdrv_init_nfo           deferred  /* /drivers/media/platform/m2m-deinterlace.c*/
 
+/*
+ * Cost hints in usecs, taken from initcall_debug on 311c (initcall_list.txt).
+ * Modules not listed cost 1, priority of them is the length of the longest chain they start
+ */
+#define MOD_COST_HINTS(fnc) \
+        fnc(ehci_pci_init,                1054312) \
+        fnc(forcedeth_pci_driver_init,     512183) \
+        fnc(ohci_pci_init,                 172522) \
+        fnc(ssb_modinit,                   164756) \
+        fnc(b43_init,                       81269) \
+        fnc(i8042_init,                     21592) \
+        fnc(prng_mod_init,                  18416) \
+        fnc(ahci_pci_driver_init,           11379) \
+        fnc(acpi_video_init,                 7845) \
+        fnc(nvidia_frontend_init_module,     6564) \
+        fnc(loop_init,                       3815) \
+        fnc(sha512_generic_mod_init,         2612) \
+        fnc(acpi_thermal_init,               2530) \
+        fnc(cmos_init,                       2467) \
+        fnc(acpi_button_driver_init,         1642) \
+        fnc(wp512_mod_init,                  1598) \
+        fnc(blowfish_mod_init,               1491) \
+        fnc(pcie_portdrv_init,               1478) \
+        fnc(acpi_ac_init,                    1014) \
+        fnc(azx_driver_init,                  767) \
+        fnc(brd_init,                         758) \
+        fnc(zlib_mod_init,                    733) \
+        fnc(tgr192_mod_init,                  682) \
+        fnc(sha256_generic_mod_init,          615) \
+        fnc(arc4_init,                        546) \
+
+/*
+ * Device nodes that trigger initialization on open, type 'c' char or 'b' block, major and class name.
+ * A major can be served by several modules, all of them are run with their parents.
+ * Name is the class in /sys/class, it can be written to deferred_initcalls too
+ */
+#define MOD_DEVICES(fnc) \
+        fnc(alsa_timer_init,         'c', 116, "sound") \
+        fnc(alsa_pcm_init,           'c', 116, "sound") \
+        fnc(alsa_hwdep_init,         'c', 116, "sound") \
+        fnc(alsa_seq_init,           'c', 116, "sound") \
+        fnc(azx_driver_init,         'c', 116, "sound") \
+        fnc(snd_hda_intel,           'c', 116, "sound") \
+        fnc(grp_snd_hda,             'c', 116, "sound") \
+        fnc(evdev_init,              'c',  13, "input") \
+        fnc(mousedev_init,           'c',  13, "input") \
+        fnc(hid_generic_init,        'c',  13, "input") \
+        fnc(grp_hid,                 'c',  13, "input") \
+        fnc(uinput_init,             'c',  10, "misc") \
+        fnc(fuse_init,               'c',  10, "misc") \
+        fnc(hpet_init,               'c',  10, "misc") \
+        fnc(nvram_init,              'c',  10, "misc") \
+        fnc(init_sg,                 'c',  21, "scsi_generic") \
+        fnc(uvc_init,                'c',  81, "video4linux") \
+        fnc(i2c_dev_init,            'c',  89, "i2c-dev") \
+        fnc(usblp_driver_init,       'c', 180, "usbmisc") \
+        fnc(brd_init,                'b',   1, "block") \
+        fnc(loop_init,               'b',   7, "block") \
+        fnc(init_sd,                 'b',   8, "block") \
+        fnc(usb_storage_driver_init, 'b',   8, "block") \
+        fnc(mmc_blk_init,            'b', 179, "block") \
+
+/*
+ * PCI ids of drivers, vendor, device and class with its mask as in their pci_device_id tables.
+ * Only entries matching our boxes (T1650-lspci, oi520-pci-vnn, lspci-lenovo) or hardware we never had are listed,
+ * a class match stands for long tables of one vendor.
+ * A driver with entries and no present device matching any of them is absent, see pci_prune.
+ * Critical drivers are never absent, ACPI and platform drivers have no PCI ids
+ */
+#define MOD_PCI_IDS(fnc) \
+        fnc(ehci_pci_init,               PCI_ANY_ID, PCI_ANY_ID, 0x0c0320, 0xffffff) \
+        fnc(ohci_pci_init,               PCI_ANY_ID, PCI_ANY_ID, 0x0c0310, 0xffffff) \
+        fnc(uhci_hcd_init,               PCI_ANY_ID, PCI_ANY_ID, 0x0c0300, 0xffffff) \
+        fnc(azx_driver_init,             PCI_ANY_ID, PCI_ANY_ID, 0x040300, 0xffff00) \
+        fnc(pcie_portdrv_init,           PCI_ANY_ID, PCI_ANY_ID, 0x060400, 0xffffff) \
+        fnc(serial_pci_driver_init,      PCI_ANY_ID, PCI_ANY_ID, 0x070000, 0xffff00) \
+        fnc(serial_pci_driver_init,      PCI_ANY_ID, PCI_ANY_ID, 0x070200, 0xffff00) \
+        fnc(serial_pci_driver_init,      PCI_ANY_ID, PCI_ANY_ID, 0x070300, 0xffff00) \
+        fnc(i2c_i801_init,               0x8086,     PCI_ANY_ID, 0x0c0500, 0xffff00) \
+        fnc(lpc_ich_driver_init,         0x8086,     PCI_ANY_ID, 0x060100, 0xffff00) \
+        fnc(lpc_sch_driver_init,         0x8086,     0x8119,     0,        0) \
+        fnc(lpc_sch_driver_init,         0x8086,     0x0f1c,     0,        0) \
+        fnc(ismt_driver_init,            0x8086,     0x0c59,     0,        0) \
+        fnc(ismt_driver_init,            0x8086,     0x0c5a,     0,        0) \
+        fnc(ismt_driver_init,            0x8086,     0x1f15,     0,        0) \
+        fnc(pch_dma_driver_init,         0x8086,     0x8810,     0,        0) \
+        fnc(pch_dma_driver_init,         0x8086,     0x8815,     0,        0) \
+        fnc(ptp_pch_init,                0x8086,     0x8819,     0,        0) \
+        fnc(ipw2100_init,                0x8086,     0x1043,     0,        0) \
+        fnc(nvidia_frontend_init_module, 0x10de,     PCI_ANY_ID, 0x030000, 0xff0000) \
+        fnc(agp_nvidia_init,             0x10de,     PCI_ANY_ID, 0x060000, 0xffff00) \
+        fnc(nforce2_driver_init,         0x10de,     PCI_ANY_ID, 0x0c0500, 0xffff00) \
+        fnc(forcedeth_pci_driver_init,   0x10de,     PCI_ANY_ID, 0x020000, 0xffff00) \
+        fnc(forcedeth_pci_driver_init,   0x10de,     PCI_ANY_ID, 0x068000, 0xffff00) \
+        fnc(ssb_modinit,                 0x14e4,     PCI_ANY_ID, 0x028000, 0xffff00) \
+        fnc(b43_init,                    0x14e4,     PCI_ANY_ID, 0x028000, 0xffff00) \
+        fnc(b43legacy_init,              0x14e4,     PCI_ANY_ID, 0x028000, 0xffff00) \
+        fnc(pcips2_driver_init,          0x14f2,     0x0123,     0,        0) \
+        fnc(pcips2_driver_init,          0x14f2,     0x0124,     0,        0) \
+        fnc(hilscher_pci_driver_init,    0x10b5,     0x9030,     0,        0) \
+        fnc(hilscher_pci_driver_init,    0x10b5,     0x9050,     0,        0) \
+
+
 #if 0
         /* ARCH  SUBSYS POSTCORE */
         fnc(dca),  /* drivers/dca/dca.ko */  \
@@ -476,7 +583,31 @@ extern struct init_fn_t_4 __async_initcall_start[], __async_initcall_end[];
 #endif
 
 #ifndef CONFIG_ASYNCHRO_MODULE_INIT_THREADS
-#define CONFIG_ASYNCHRO_MODULE_INIT_THREADS 1
+#define CONFIG_ASYNCHRO_MODULE_INIT_THREADS 0
+#endif
+
+#ifndef CONFIG_ASYNCHRO_MODULE_INIT_PCI_PRUNE
+#define CONFIG_ASYNCHRO_MODULE_INIT_PCI_PRUNE 1
+#endif
+
+#ifndef CONFIG_ASYNCHRO_MODULE_INIT_OVERDUE
+#define CONFIG_ASYNCHRO_MODULE_INIT_OVERDUE 2000
+#endif
+
+#ifndef CONFIG_ASYNCHRO_MODULE_INIT_OVERDUE_DEFERRED
+#define CONFIG_ASYNCHRO_MODULE_INIT_OVERDUE_DEFERRED 10000
+#endif
+
+#ifndef CONFIG_ASYNCHRO_MODULE_INIT_OVERDUE_CRITICAL
+#define CONFIG_ASYNCHRO_MODULE_INIT_OVERDUE_CRITICAL 5000
+#endif
+
+#ifndef CONFIG_ASYNCHRO_MODULE_INIT_PROFILE
+#define CONFIG_ASYNCHRO_MODULE_INIT_PROFILE "/async_minit.profile"
+#endif
+
+#ifndef CONFIG_ASYNCHRO_MODULE_INIT_BACKGROUND
+#define CONFIG_ASYNCHRO_MODULE_INIT_BACKGROUND 0
 #endif
 
 /*
@@ -488,41 +619,324 @@ enum task_status_t_4
   st_waiting,    //
   st_running,    //
   st_done,
+  st_failed,     // returned an error
+  st_skipped,    // a parent failed, never executed
 };
 
 struct task_info_t_4
 {
-    unsigned ref;       // how many modules we need to release this task
-    unsigned status;        // task status (disable, waiting, running, done)
+    atomic_t ref;       // how many parents or group members still to be done
+    atomic_t status;        // task status (disable, waiting, running, done, failed, skipped)
     unsigned child_count;    // count of child task waiting for this one
+    unsigned instances;      // init functions registered with this id
+    unsigned prio;           // longest path cost from this task to the end of its chain
+    int ret;                 // initcall return code, failed parent one when skipped
+    unsigned parts;          // init memory parts holding its init functions, a bit for each part
+    unsigned task_idx;       // position in task list
+    unsigned owner;          // working thread + 1 holding it in its ready deque, 0 none
+    unsigned absent;         // driver without any present PCI device or without hardware in last boot
+    unsigned cost;           // usecs from last boot profile or cost hint
+    enum task_type_t type;   // table type or boot parameter override
 };
 
-#define get_nfo_1(type)             {type,grp_none_id, none_id,none_id } ,
-#define get_nfo_2(type,grp)         {type,grp ## _id, none_id,none_id }  ,
-#define get_nfo_3(type,grp,p1)      {type,grp ## _id, p1 ## _id,none_id },
-#define get_nfo_4(type,grp,p1,p2)   {type,grp ## _id, p1 ## _id, p2 ## _id },
+/*
+ * _nfo format is type[,group[,parent...]], any number of parents up to CALL_FNC limit.
+ * Parents of all modules are stored in one flat array, parents_of_x is the first one for module x
+ */
+#define get_nfo_1(type)                  type, grp_none_id
+#define get_nfo_2(type,grp,...)          type, grp ## _id
+#define get_nfo_3                        get_nfo_2
+#define get_nfo_4                        get_nfo_2
+#define get_nfo_5                        get_nfo_2
+#define get_nfo_6                        get_nfo_2
+#define get_nfo_7                        get_nfo_2
+#define get_nfo_8                        get_nfo_2
+#define get_nfo_9                        get_nfo_2
+#define get_nfo_10                       get_nfo_2
+#define get_nfo_11                       get_nfo_2
+#define get_nfo_12                       get_nfo_2
+#define get_nfo_13                       get_nfo_2
+#define get_nfo_14                       get_nfo_2
+#define get_nfo_15                       get_nfo_2
+#define get_nfo_16                       get_nfo_2
+
+#define parents_count_1(...)             0
+#define parents_count_2(...)             0
+#define parents_count_3(...)             1
+#define parents_count_4(...)             2
+#define parents_count_5(...)             3
+#define parents_count_6(...)             4
+#define parents_count_7(...)             5
+#define parents_count_8(...)             6
+#define parents_count_9(...)             7
+#define parents_count_10(...)            8
+#define parents_count_11(...)            9
+#define parents_count_12(...)            10
+#define parents_count_13(...)            11
+#define parents_count_14(...)            12
+#define parents_count_15(...)            13
+#define parents_count_16(...)            14
+
+#define parent_ids_1(p)                  p ## _id,
+#define parent_ids_2(p,...)              p ## _id, parent_ids_1(__VA_ARGS__)
+#define parent_ids_3(p,...)              p ## _id, parent_ids_2(__VA_ARGS__)
+#define parent_ids_4(p,...)              p ## _id, parent_ids_3(__VA_ARGS__)
+#define parent_ids_5(p,...)              p ## _id, parent_ids_4(__VA_ARGS__)
+#define parent_ids_6(p,...)              p ## _id, parent_ids_5(__VA_ARGS__)
+#define parent_ids_7(p,...)              p ## _id, parent_ids_6(__VA_ARGS__)
+#define parent_ids_8(p,...)              p ## _id, parent_ids_7(__VA_ARGS__)
+#define parent_ids_9(p,...)              p ## _id, parent_ids_8(__VA_ARGS__)
+#define parent_ids_10(p,...)             p ## _id, parent_ids_9(__VA_ARGS__)
+#define parent_ids_11(p,...)             p ## _id, parent_ids_10(__VA_ARGS__)
+#define parent_ids_12(p,...)             p ## _id, parent_ids_11(__VA_ARGS__)
+#define parent_ids_13(p,...)             p ## _id, parent_ids_12(__VA_ARGS__)
+#define parent_ids_14(p,...)             p ## _id, parent_ids_13(__VA_ARGS__)
+#define parent_ids(...)                  COUNT_ARG(parent_ids_,__VA_ARGS__)(__VA_ARGS__)
+
+#define get_parents_1(type)
+#define get_parents_2(type,grp)
+#define get_parents_3(type,grp,...)      parent_ids(__VA_ARGS__)
+#define get_parents_4                    get_parents_3
+#define get_parents_5                    get_parents_3
+#define get_parents_6                    get_parents_3
+#define get_parents_7                    get_parents_3
+#define get_parents_8                    get_parents_3
+#define get_parents_9                    get_parents_3
+#define get_parents_10                   get_parents_3
+#define get_parents_11                   get_parents_3
+#define get_parents_12                   get_parents_3
+#define get_parents_13                   get_parents_3
+#define get_parents_14                   get_parents_3
+#define get_parents_15                   get_parents_3
+#define get_parents_16                   get_parents_3
+
+#define get_nfo(x)          { CALL_FNC(get_nfo_,x ## _nfo), parents_of_ ## x, CALL_FNC(parents_count_,x ## _nfo) },
+#define get_parents(x)      CALL_FNC(get_parents_,x ## _nfo)
+#define get_parents_first(x) parents_of_ ## x, parents_last_ ## x = parents_of_ ## x + CALL_FNC(parents_count_,x ## _nfo) - 1,
+
+enum { MODULES_ID(get_parents_first) parents_max };
 
-#define get_nfo(x) CALL_FNC(get_nfo_,x ## _nfo)
+/*
+ * Async initcalls are linked in async_minit_order.h order, every module after its parents and before its group.
+ * A cycle or an order older than the table does not compile, regenerate it with utils/async-order
+ */
+#ifdef ASYNC_INITCALLS_ORDER
+#define rank_before_1(x,p)               (p ## _rank < x ## _rank)
+#define rank_before_2(x,p,...)           (p ## _rank < x ## _rank && rank_before_1(x,__VA_ARGS__))
+#define rank_before_3(x,p,...)           (p ## _rank < x ## _rank && rank_before_2(x,__VA_ARGS__))
+#define rank_before_4(x,p,...)           (p ## _rank < x ## _rank && rank_before_3(x,__VA_ARGS__))
+#define rank_before_5(x,p,...)           (p ## _rank < x ## _rank && rank_before_4(x,__VA_ARGS__))
+#define rank_before_6(x,p,...)           (p ## _rank < x ## _rank && rank_before_5(x,__VA_ARGS__))
+#define rank_before_7(x,p,...)           (p ## _rank < x ## _rank && rank_before_6(x,__VA_ARGS__))
+#define rank_before_8(x,p,...)           (p ## _rank < x ## _rank && rank_before_7(x,__VA_ARGS__))
+#define rank_before_9(x,p,...)           (p ## _rank < x ## _rank && rank_before_8(x,__VA_ARGS__))
+#define rank_before_10(x,p,...)          (p ## _rank < x ## _rank && rank_before_9(x,__VA_ARGS__))
+#define rank_before_11(x,p,...)          (p ## _rank < x ## _rank && rank_before_10(x,__VA_ARGS__))
+#define rank_before_12(x,p,...)          (p ## _rank < x ## _rank && rank_before_11(x,__VA_ARGS__))
+#define rank_before_13(x,p,...)          (p ## _rank < x ## _rank && rank_before_12(x,__VA_ARGS__))
+#define rank_before_14(x,p,...)          (p ## _rank < x ## _rank && rank_before_13(x,__VA_ARGS__))
+
+#define rank_ok_1(x,type)                1
+#define rank_ok_2(x,type,grp)            (x ## _rank < grp ## _rank)
+#define rank_ok_3(x,type,grp,...)        (x ## _rank < grp ## _rank && COUNT_ARG(rank_before_,__VA_ARGS__)(x,__VA_ARGS__))
+#define rank_ok_4(x,type,grp,...)        (x ## _rank < grp ## _rank && COUNT_ARG(rank_before_,__VA_ARGS__)(x,__VA_ARGS__))
+#define rank_ok_5(x,type,grp,...)        (x ## _rank < grp ## _rank && COUNT_ARG(rank_before_,__VA_ARGS__)(x,__VA_ARGS__))
+#define rank_ok_6(x,type,grp,...)        (x ## _rank < grp ## _rank && COUNT_ARG(rank_before_,__VA_ARGS__)(x,__VA_ARGS__))
+#define rank_ok_7(x,type,grp,...)        (x ## _rank < grp ## _rank && COUNT_ARG(rank_before_,__VA_ARGS__)(x,__VA_ARGS__))
+#define rank_ok_8(x,type,grp,...)        (x ## _rank < grp ## _rank && COUNT_ARG(rank_before_,__VA_ARGS__)(x,__VA_ARGS__))
+#define rank_ok_9(x,type,grp,...)        (x ## _rank < grp ## _rank && COUNT_ARG(rank_before_,__VA_ARGS__)(x,__VA_ARGS__))
+#define rank_ok_10(x,type,grp,...)       (x ## _rank < grp ## _rank && COUNT_ARG(rank_before_,__VA_ARGS__)(x,__VA_ARGS__))
+#define rank_ok_11(x,type,grp,...)       (x ## _rank < grp ## _rank && COUNT_ARG(rank_before_,__VA_ARGS__)(x,__VA_ARGS__))
+#define rank_ok_12(x,type,grp,...)       (x ## _rank < grp ## _rank && COUNT_ARG(rank_before_,__VA_ARGS__)(x,__VA_ARGS__))
+#define rank_ok_13(x,type,grp,...)       (x ## _rank < grp ## _rank && COUNT_ARG(rank_before_,__VA_ARGS__)(x,__VA_ARGS__))
+#define rank_ok_14(x,type,grp,...)       (x ## _rank < grp ## _rank && COUNT_ARG(rank_before_,__VA_ARGS__)(x,__VA_ARGS__))
+#define rank_ok_15(x,type,grp,...)       (x ## _rank < grp ## _rank && COUNT_ARG(rank_before_,__VA_ARGS__)(x,__VA_ARGS__))
+#define rank_ok_16(x,type,grp,...)       (x ## _rank < grp ## _rank && COUNT_ARG(rank_before_,__VA_ARGS__)(x,__VA_ARGS__))
+
+#define rank_ok(x,...)      COUNT_ARG(rank_ok_,__VA_ARGS__)(x,__VA_ARGS__)
+#define check_rank(x)       typedef char rank_of_ ## x[rank_ok(x,x ## _nfo) ? 1 : -1];
+MODULES_ID(check_rank)
+#endif
 
 // it is better use a unique place for modules info
 struct  init_fnc_info_4 {
   enum task_type_t type;
   modules_e  grp_id;
-  modules_e  parent1_id;
-  modules_e  parent2_id;
+  unsigned short parents;          // first parent in init_parents
+  unsigned short parents_count;
 };
 
-const static struct  init_fnc_info_4  /*__initdata*/ init_info[] = {
+const static struct  init_fnc_info_4  init_info[] __async_minit_initconst = {
     MODULES_ID(get_nfo)
     {} };
 
-struct task_info_t_4  /*__initdata*/ info_4[module_last + 1];    // all task info
-//struct init_fn_t* current_init_fnc;      // current init function to execute
-//enum task_type_t  current_type;          // current type.
+static const modules_e init_parents[parents_max + 1] __async_minit_initconst = {
+    MODULES_ID(get_parents)
+    none_id };
+
+struct task_info_t_4  info_4[module_last + 1] __async_minit_initdata;    // all task info
+
+/*
+ * Dependencies grouped by parent id (compressed sparse rows).
+ * Children of id are child_list[child_first[id]] .. child_list[child_first[id + 1] - 1]
+ * a group is a child of all its members, when the last one is done the group is done.
+ * Table size is known at build time, one edge for each parent in _nfo and one for the group
+ */
+enum { edges_max = parents_max + module_last };
+
+static unsigned  child_first[module_last + 1] __async_minit_initdata;
+static modules_e child_list[edges_max] __async_minit_initdata;
+
+#define get_cost(x,usecs)   { x ## _id, usecs },
+static const struct { modules_e id; unsigned cost; } init_cost[] __async_minit_initconst = {
+    MOD_COST_HINTS(get_cost)
+    { none_id, 0 } };
+
+#define get_device(x,type,major,name)   { x ## _id, type, major, name },
+static const struct { modules_e id; char type; unsigned short major; const char* name; } init_devices[] __async_minit_initconst = {
+    MOD_DEVICES(get_device)
+    { none_id, 0, 0, NULL } };
+
+#define get_pci(x,vendor,device,cls,cls_mask)   { x ## _id, vendor, device, cls, cls_mask },
+static const struct { modules_e id; unsigned vendor; unsigned device; unsigned cls; unsigned cls_mask; } init_pci[] __async_minit_initconst = {
+    MOD_PCI_IDS(get_pci)
+    { none_id, 0, 0, 0, 0 } };
+
+/*
+ * What to do with absent drivers, PCI devices are enumerated by subsys initcalls before asynchronized stage.
+ * Deferring them keeps hotplug working, they still run when deferred_initcalls is written
+ */
+enum { prune_none, prune_defer, prune_disable };
+static unsigned pci_prune = CONFIG_ASYNCHRO_MODULE_INIT_PCI_PRUNE;
+
+static DECLARE_WAIT_QUEUE_HEAD( list_wait);
+static DECLARE_WAIT_QUEUE_HEAD( demand_wait);     // tasks demanded by an open waiting for another thread
+static DECLARE_WAIT_QUEUE_HEAD( group_wait);      // waiting for a group to be over
+static atomic_t groups_gen = ATOMIC_INIT(0);      // incremented every time a group is over
+
+/*
+ * Critical tasks and all their parents come before anything else,
+ * kernel_init waits for them to mount root file system while the rest keeps running
+ */
+enum { critical_boost = 1 << 28 };       // priority flag of critical tasks and their parents, more than any chain cost
+enum { cost_max = critical_boost - 1 };  // usecs of one task and of a chain, above it they are clamped
+static atomic_t critical_left = ATOMIC_INIT(0);        // critical tasks not done, failed or skipped
+static DECLARE_COMPLETION(critical_done);
+
+/*
+ * Init memory is released in parts, each one a text range in .init.text and a data range in .init.data.
+ * Generic part, everything but the other two, when kernel_init and every task with code there are done,
+ * free_init_ref counts kernel_init and async ones.
+ * Deferred part, generated driver init functions of deferred modules (ASYNC_DEFERRED_TEXT),
+ * when every task with code there is done. It has no data range, driver data is not kept apart.
+ * Scheduler part, tables, registrations and the code filling the task list (__async_minit_init),
+ * last when deferred stage is over
+ */
+enum init_part_t { part_generic, part_deferred, part_scheduler, part_last };
+
+#ifndef TEST
+extern char __deferred_text_begin[], __deferred_text_end[], __async_minit_text_begin[], __async_minit_text_end[];
+extern char __async_minit_data_begin[], __async_minit_data_end[];
+#endif
+extern atomic_t  free_init_ref;         // become zero when kernel_init and asynchronized tasks are done
+static atomic_t generic_left = ATOMIC_INIT(0);         // tasks with code in generic part not done
+static atomic_t deferred_left = ATOMIC_INIT(0);        // tasks with code in deferred part not done
+static atomic_t scheduler_ref = ATOMIC_INIT(1);        // deferred stage and running demands
+
+/*
+ * Task list holds first registration of each id sorted by priority, highest first.
+ * A parent has always higher priority than its children so the list is also in dependency order.
+ * first_waiting is the index of the first task not done yet.
+ * Only tasks behind it are done, a worker looks for a ready task starting from there
+ * and takes it moving its status from waiting to running with an atomic exchange.
+ * Everything is done when first_waiting reaches the end of the list.
+ */
+static const struct init_fn_t_4* tasks_end;            // end of registered tasks
+static const struct init_fn_t_4* task_list[module_last] __async_minit_initdata;  // tasks by priority
+static unsigned tasks_count;                           // tasks in task_list
+static atomic_t first_waiting = ATOMIC_INIT(0);        // first task not done
+static enum task_type_t current_type = asynchronized;  // stage in execution
+static atomic_t list_gen = ATOMIC_INIT(0);             // incremented every time a task is done
+static atomic_t threads_active = ATOMIC_INIT(0);       // working threads not sleeping
+static unsigned stage_done;                            // nothing ready and nothing running
+static atomic_t threads_running = ATOMIC_INIT(0);      // working threads alive
+
+/*
+ * Ready deque of each working thread, a thread is bound to an online cpu and uses the deque of that cpu,
+ * worker_cpu maps working threads to cpus, online cpu ids may have gaps.
+ * Threads added to a stage share the deque of thread worker % deques_count, a replacement
+ * takes the one of the thread written off.
+ * Children released by a task are pushed to the deque of the thread that ran it and it takes
+ * the last one pushed next, data touched by the parent is still in its cache.
+ * Idle threads steal the oldest one from other deques. Tasks in a deque are skipped by the
+ * task list scan, deque entries are only hints, a task is still taken moving its status.
+ * A full deque leaves new ready tasks to the task list scan
+ */
+enum { deque_size = 32 };
+
+struct ready_deque_t_4
+{
+    spinlock_t lock;
+    unsigned head;                  // next push, owner pops from here
+    unsigned tail;                  // oldest entry, thieves take from here
+    modules_e task[deque_size];
+};
+
+static DEFINE_PER_CPU(struct ready_deque_t_4, ready_deque);
+static unsigned deques_count;                          // threads a stage starts with, one deque each
+
+/*
+ * Hung initcall watchdog. A working thread running one task longer than the deadline of the task type
+ * is written off, the task is overdue and only its dependents wait for it.
+ * The thread leaves stage accounting and a replacement takes its place,
+ * the stage can be over with the overdue task still running. When it returns its thread finishes it
+ * and exits, ready dependents run on working threads or in the next stage.
+ * Deadlines are msecs by type, 0 never overdue.
+ * The watchdog also grows the pool, a stage starts with pool_width threads
+ * and another one is added while tasks are ready, no thread is parked and a cpu is idle.
+ * Threads sleeping in an initcall (msleep in a probe, firmware) do not count against pool_width,
+ * a stage never has more than twice pool_width threads alive. async_minit.grow=0 keeps pool_width threads
+ */
+enum { workers_max = 64, overdue_flag = 1 << 30, watch_period = 10 };
+
+static unsigned overdue_msecs[disable] = { CONFIG_ASYNCHRO_MODULE_INIT_OVERDUE,
+    CONFIG_ASYNCHRO_MODULE_INIT_OVERDUE_DEFERRED, CONFIG_ASYNCHRO_MODULE_INIT_OVERDUE_CRITICAL };
 
+struct worker_watch_t_4
+{
+    atomic_t task;                  // running task id + 1, with overdue_flag when written off, 0 none
+    u64 deadline;                   // local_clock() when the running task is overdue
+    struct task_struct* thread;     // its state tells a thread blocked in the task
+};
+
+static struct worker_watch_t_4 worker_watch[workers_max];
+static unsigned worker_cpu[workers_max];               // cpu of the deque of each working thread
+static atomic_t workers_count = ATOMIC_INIT(0);        // working threads of current stage, added ones and replacements
+static atomic_t tasks_overdue = ATOMIC_INIT(0);
+static atomic_t workers_added = ATOMIC_INIT(0);        // threads added to stages by the watchdog
+static unsigned pool_width;                            // threads of a stage running at once
+static unsigned pool_grow = 1;                         // watchdog adds threads, 0 keeps pool_width
+static DECLARE_WAIT_QUEUE_HEAD( watch_wait);           // watchdog sleeps between checks
+
+/*
+ * Time record of every executed initcall, kept after init memory is released for /proc export.
+ * Times are local_clock() nsecs, dependencies wait is ready - tasks_filled,
+ * queue wait is start - ready
+ */
+enum { worker_demand = 0xfffd, worker_reader = 0xfffe, worker_default = 0xffff };     // no working thread
+
+struct task_time_t_4
+{
+    u64 ready;                // last parent done
+    u64 start;
+    u64 end;
+    int ret;                  // do_one_initcall return code
+    unsigned short cpu;
+    unsigned short worker;    // working thread index or worker_reader, worker_default
+};
 
-//static DEFINE_SPINLOCK(list_lock);
-//static DECLARE_WAIT_QUEUE_HEAD( list_wait);
+static struct task_time_t_4 task_time[module_last];
+static u64 tasks_filled;                               // time when dependencies are known
 
 
 //#ifdef CONFIG_ASYNCHRO_MODULE_INIT_DEBUG
@@ -542,328 +956,1742 @@ const char* getName(modules_e id)
  * Initialize modules dynamic data
  */
 /*
- * Read all information from static memory an expand it to dynamic memory
+ * Count an edge only when parent is going to run, a parent not registered
+ * or disabled will never be done and nobody has to wait for it
  */
-void FillTasks(const struct init_fn_t_4* begin, const struct init_fn_t_4* end)
+static inline void __async_minit_init CountEdge(modules_e parent, modules_e child)
 {
-  const struct init_fn_t_4* it;
-  const struct init_fnc_info_4* nfo;
-  memset(info_4, 0, sizeof(info_4));      //clear all status information
-  // update child and group reference counter
-  for (it = begin; it != end; ++it)
-  {
-    nfo = &init_info[it->id];
-    info_4[it->id].status = st_waiting;
-    if (nfo->parent1_id != none_id)
-    {
-      ++info_4[nfo->parent1_id].child_count;
-    }
-    if (nfo->parent2_id != none_id)
-      ++info_4[nfo->parent2_id].child_count;
-
-    if (nfo->grp_id != grp_none_id)
-    {
-      info_4[nfo->grp_id].ref++;     // also use as group counter
-      info_4[nfo->grp_id].status = st_waiting;
-    }
-  }
-  info_4[none_id].status = st_done;
-  info_4[grp_none_id].status = st_done;
-}
-
-//const task_info_t* peekTask(const task_info_t* it)
-//  {
-//    bool towait;    // if true means wait for completion, false return current task or null
-//    unsigned child_count = 0; // how many child to wakeup
-//    std::unique_lock < std::mutex > lock(mtx);
-//    if (it != nullptr)
-//    {
-//      status[it->id].status = done;
-//      child_count += status[it->id].child_count;
-//      if (it->grp_id != ID::grp_none_id)
-//      {
-//        --status[it->grp_id].grp_ref;
-//        if (status[it->grp_id].grp_ref == 0)
-//        {
-//          child_count += status[it->grp_id].child_count;
-//          status[it->grp_id].status = done;
-//        }
-//      }
-//      // put back all done task
-//      if (it == begin)
-//      {
-//        while (begin != end && status[begin->id].status == done)
-//          ++begin;
-//      }
-//    }
-//    for (;;)
-//    {
-//      towait = false;    // no task to waiting for
-//      for (it = begin; it != end; ++it)
-//      {
-//        // find any ready task
-//        if (status[it->id].status == waiting)
-//        {
-//          if (status[it->parent_id].status == done && status[it->parent_id2].status == done)
-//          {
-//            status[it->id].status = running;
-//            break;
-//          }
-//          towait = true;
-//        }
-//      }
-//      if (it != end)
-//        break;     // get out for ;;
-//      // we got nothing
-//      if (towait)    // wait and try again
-//      {
-//        std::cout << 'W' << std::endl;
-//        cond_var.wait(lock);
-//      }
-//      else
-//      {
-//        it = nullptr;    // we done here
-//        child_count = 3;  // wake_up all task because we done
-//        break;    // get out for ;;
-//      }
-//    }
+  if (parent == none_id || parent == grp_none_id)
+    return;
+  if (atomic_read(&info_4[parent].status) != st_waiting)
+    return;
+  ++info_4[parent].child_count;
+  atomic_inc(&info_4[child].ref);
+}
 
+static inline void __async_minit_init PutEdge(modules_e parent, modules_e child)
+{
+  if (parent == none_id || parent == grp_none_id)
+    return;
+  if (atomic_read(&info_4[parent].status) != st_waiting)
+    return;
+  child_list[--child_first[parent]] = child;
+}
 
-/**
- * Thread for version 2
+/*
+ * Registered task, groups are waiting too but they are never executed
  */
+static inline int IsTask(unsigned id)
+{
+  return info_4[id].type != disable && atomic_read(&info_4[id].status) == st_waiting;
+}
 
-int  ProcessThread2(void *data)
+/*
+ * Longest path cost starting at id, children are done first so it is computed once for each task.
+ * A group costs nothing, it is done with its last member
+ */
+static unsigned __async_minit_init TaskPriority(modules_e id)
 {
-//    int ret;
-//    struct task_t* ptask = NULL;
-//    printk_debug("async %d starts\n", (unsigned )data);
-//    do
-//    {
-//        ret = wait_event_interruptible(list_wait, (ptask = PeekTask()) != NULL || tasks.type_ != waiting);
-//        if (ret != 0)
-//        {
-//            printk("async init wake up returned %d\n", ret);
-//            break;
-//        }
-//        if (ptask != NULL)
-//        {
-//            printk_debug("async %d %pF %s\n", (unsigned)data, ptask->fnc,getName(ptask->id));
-//            ret = do_one_initcall(ptask->fnc);
-//            //TODO check return code and invalidate all task that depends on this one
-//            TaskDone2(ptask);
-//        }
-//    } while (ptask != 0);
-//    printk_debug("async %d ends\n", (unsigned)data);
-    return 0;
+  unsigned prio = 0;
+  unsigned idx;
+  unsigned child;
+  if (info_4[id].prio != 0)
+    return info_4[id].prio;
+  for (idx = child_first[id]; idx != child_first[id + 1]; ++idx)
+  {
+    child = TaskPriority(child_list[idx]);
+    if (child > prio)
+      prio = child;
+  }
+  if (info_4[id].type != disable)
+  {
+    // a long chain saturates, its cost never reaches the critical flag
+    prio = min((prio & cost_max) + 1 + info_4[id].cost, (unsigned)cost_max) | (prio & critical_boost);
+    if (info_4[id].type == critical)
+      prio |= critical_boost;     // once, a critical child may have set it already
+  }
+  info_4[id].prio = prio;
+  return prio;
 }
 
-/**
- * Execute all initialization for an specific type
- * We need wait for everything done as a barrier to avoid problems
+/*
+ * Sort task list by priority, highest first.
+ * Insertion sort keeps registration order between tasks with the same priority
  */
-int  start_threads(int(* thread_fnc) (void*) )
+static void __async_minit_init SortTasks(void)
 {
-    unsigned max_cpus = num_online_cpus();
-    unsigned it;
-    static struct task_struct *thr;
-    if (max_cpus > CONFIG_ASYNCHRO_MODULE_INIT_THREADS)
-    {
-        max_cpus = CONFIG_ASYNCHRO_MODULE_INIT_THREADS;
-    }
-    // validated cpu count
-    if (max_cpus == 0)
-        max_cpus = 1;
+  const struct init_fn_t_4* it;
+  unsigned idx;
+  unsigned pos;
+  for (idx = 1; idx < tasks_count; ++idx)
+  {
+    it = task_list[idx];
+    for (pos = idx; pos != 0 && info_4[task_list[pos - 1]->id].prio < info_4[it->id].prio; --pos)
+      task_list[pos] = task_list[pos - 1];
+    task_list[pos] = it;
+  }
+}
 
-    // leave one thread free
-    if (/*type == deferred && */ max_cpus > 1)
-    {
-        --max_cpus;
-    }
-    printk_debug("async using %d cpus\n", max_cpus);
-    for (it=0; it < max_cpus;  ++it)
-    {
-        //start working threads
-        thr = kthread_create(thread_fnc, (void* )(it), "async_thread_%d",it);
-        if (thr != ERR_PTR(-ENOMEM))
-        {
-            kthread_bind(thr, it);
-            wake_up_process(thr);
-        }
-        else
-        {
-            printk("Async module initialization thread failed .. fall back to normal mode");
-            thread_fnc(NULL);
-        }
-    }
-    return 0;
+/*
+ * Init memory part holding an init function
+ */
+static inline enum init_part_t InitPart(initcall_t fnc)
+{
+  const char* addr = (const char*)fnc;
+  if (addr >= __deferred_text_begin && addr < __deferred_text_end)
+    return part_deferred;
+  if (addr >= __async_minit_text_begin && addr < __async_minit_text_end)
+    return part_scheduler;
+  return part_generic;
 }
 
-static atomic_t init_done = ATOMIC_INIT(0);
-extern atomic_t  free_init_ref;         // become zero when all drivers are initialize.
-// current module
+void __weak free_initmem_part(void* begin, void* end, const char* what)
+{
+  free_reserved_area(begin, end, POISON_FREE_INITMEM, what);
+}
 
+/*
+ * Parts are page aligned and laid out as __init_begin generic text, deferred text, scheduler text,
+ * generic text and data, scheduler data, generic data __init_end
+ */
+static void FreeInitPart(enum init_part_t part)
+{
+  switch (part)
+  {
+  case part_generic:
+    free_initmem_part(__init_begin, __deferred_text_begin, "unused kernel");
+    free_initmem_part(__async_minit_text_end, __async_minit_data_begin, "unused kernel");
+    free_initmem_part(__async_minit_data_end, __init_end, "unused kernel");
+    break;
+  case part_deferred:
+    free_initmem_part(__deferred_text_begin, __deferred_text_end, "deferred init");
+    break;
+  default:
+    free_initmem_part(__async_minit_text_begin, __async_minit_text_end, "async init");
+    free_initmem_part(__async_minit_data_begin, __async_minit_data_end, "async init");
+    break;
+  }
+}
 
+/*
+ * Drop a generic init memory reference, kernel_init drops its own one when it is done
+ */
+void async_minit_release_init(void)
+{
+  if (atomic_dec_and_test(&free_init_ref))
+    FreeInitPart(part_generic);
+}
+EXPORT_SYMBOL(async_minit_release_init);
 
+#ifdef CONFIG_PCI
 /*
- * Do all initialization by default way
+ * Mark drivers with PCI ids and no present device matching them as absent, one pass over all devices
  */
-int doall_default(void* d)
+static void __async_minit_init FindAbsent(void)
 {
-    int old = atomic_xchg(&init_done, 1);
-    if (old == 0)
+  struct pci_dev* dev = NULL;
+  unsigned idx;
+  if (pci_prune == prune_none)
+    return;
+  for (idx = 0; init_pci[idx].id != none_id; ++idx)
+  {
+    if (info_4[init_pci[idx].id].type != critical)
+      info_4[init_pci[idx].id].absent = 1;
+  }
+  for_each_pci_dev(dev)
+  {
+    for (idx = 0; init_pci[idx].id != none_id; ++idx)
     {
-        int ret;
-        const struct init_fn_t_4* it_init_fnc;
-        for (it_init_fnc = __async_initcall_start; it_init_fnc < __async_initcall_end; ++it_init_fnc)
-        {
-            ret = do_one_initcall(it_init_fnc->fnc);
-            schedule();        // give time to system to do other things
-        }
+      if ((init_pci[idx].vendor == PCI_ANY_ID || init_pci[idx].vendor == dev->vendor)
+          && (init_pci[idx].device == PCI_ANY_ID || init_pci[idx].device == dev->device)
+          && ((init_pci[idx].cls ^ dev->class) & init_pci[idx].cls_mask) == 0)
+        info_4[init_pci[idx].id].absent = 0;
     }
-    if (atomic_dec_and_test(&free_init_ref) )
-          free_initmem();
-    return 0;
+  }
+  for (idx = 0; init_pci[idx].id != none_id; ++idx)
+  {
+    if (info_4[init_pci[idx].id].absent)
+      printk_debug("async %s no PCI device\n", getName(init_pci[idx].id));
+  }
+}
+#else
+static inline void FindAbsent(void)
+{
 }
+#endif
 
 /*
- * wait for all task to be done
- * todo use a global counter equal to 2 to known when all stages are done (asyn,deferred) use a wait queue for notification
+ * Profile of the last boot, "name usecs ret" records of executed initcalls separated by spaces, colons,
+ * commas or new lines. Userspace writes it from /proc/async_initcall_times to the initramfs file
+ * CONFIG_ASYNCHRO_MODULE_INIT_PROFILE or to the command line as async_minit.profile=name:usecs:ret,...
+ * Costs replace the hints, an asynchronized driver that found no hardware (-ENODEV) is left to
+ * deferred stage like an absent PCI one and workers are limited to the parallelism of the schedule
  */
-inline void wait_(void)
+enum { profile_max = 32 << 10 };         // file bytes read
+static char* profile_cmdline __async_minit_initdata;
+static unsigned profile_records;
+static unsigned profile_threads;         // workers worth running, 0 without profile
+
+static int __init ProfileSetup(char* str)
 {
- //   wait_event_interruptible(list_wait, (tasks.type_ == waiting));
+  profile_cmdline = str;
+  return 1;
 }
+__setup("async_minit.profile=", ProfileSetup);
 
-/**
- * Module initialization is taking a long time, more than any other.
- * Module initialization and fist execution is going to be do from thread
+/*
+ * Id of a name len chars long looking from first on, module_last when it is not built in this kernel
  */
+static unsigned __async_minit_init FindId(const char* name, unsigned len, unsigned first)
+{
+  unsigned tries;
+  unsigned id = first;
+  for (tries = 0; tries != module_last; ++tries, id = (id + 1) % module_last)
+  {
+    if (strncmp(getName((modules_e)id), name, len) == 0 && getName((modules_e)id)[len] == 0)
+      return id;
+  }
+  return module_last;
+}
 
-
-/**
- * Do an normal initialization for an specific type
+/*
+ * Names are looked up from the last one found, a profile written from /proc comes in id order
  */
-int do_asynchronized(void* d)
+static void __async_minit_init ParseProfile(const char* text)
 {
-    int ret;
-    const struct init_fn_t_4* it_init_fnc;
-    for (it_init_fnc = __async_initcall_start; it_init_fnc < __async_initcall_end; ++it_init_fnc)
+  static const char seps[] = " \t\n,:";
+  unsigned long usecs;
+  long ret;
+  char* end;
+  unsigned len;
+  unsigned id = 0;
+  unsigned found;
+  for (;;)
+  {
+    text += strspn(text, seps);
+    len = strcspn(text, seps);
+    if (len == 0)
+      break;
+    found = FindId(text, len, id);
+    text += len;
+    text += strspn(text, seps);
+    usecs = simple_strtoul(text, &end, 10);
+    text = end;
+    text += strspn(text, seps);
+    ret = simple_strtol(text, &end, 10);
+    text = end;
+    if (found == module_last)
+      continue;
+    id = found;
+    info_4[id].cost = min(usecs, (unsigned long)cost_max);
+    if (ret == -ENODEV && info_4[id].type == asynchronized)
+      info_4[id].absent = 1;
+    ++profile_records;
+  }
+}
+
+static void __async_minit_init LoadProfile(void)
+{
+  struct file* file;
+  char* buf;
+  int len;
+  profile_records = 0;
+  profile_threads = 0;
+  if (profile_cmdline != NULL)
+    ParseProfile(profile_cmdline);
+  if (CONFIG_ASYNCHRO_MODULE_INIT_PROFILE[0] == 0)
+    return;
+  file = filp_open(CONFIG_ASYNCHRO_MODULE_INIT_PROFILE, O_RDONLY, 0);
+  if (IS_ERR(file))
+    return;
+  buf = kmalloc(profile_max, GFP_KERNEL);
+  if (buf != NULL)
+  {
+    len = kernel_read(file, 0, buf, profile_max - 1);
+    if (len > 0)
     {
-        if (init_info[it_init_fnc->id].type == asynchronized)
-        {
-            ret = do_one_initcall(it_init_fnc->fnc);
-            schedule();        // give time to system to do other things
-        }
+      buf[len] = 0;
+      ParseProfile(buf);
     }
-//    if (atomic_dec_and_test(&free_init_ref) )
-//             free_initmem();
-    return 0;
+    kfree(buf);
+  }
+  filp_close(file, NULL);
 }
 
 /*
- * Structure holding all device file data
+ * Boot parameters applied to the table without a rebuild, lists are comma separated:
+ * async_minit.threads=4 async_minit.defer=b43_init,ipw2100_init async_minit.async=.. async_minit.critical=..
+ * async_minit.disable=.. async_minit.prio=ext4_init_fs:100,..
+ * Types change only for modules with a type in the table, groups and disabled ones keep theirs.
+ * prio is the own cost of a module in usecs, chain priority still puts parents first
  */
-struct device_t
+static char* override_type[disable + 1] __async_minit_initdata;     // names by new type
+static char* override_prio __async_minit_initdata;
+static unsigned override_threads;                                  // workers, 0 from Kconfig and profile
+
+#define OVERRIDE_SETUP(type, param) \
+static int __init type ## _setup(char* str) \
+{ \
+  override_type[type] = str; \
+  return 1; \
+} \
+__setup("async_minit." #param "=", type ## _setup);
+
+OVERRIDE_SETUP(asynchronized, async)
+OVERRIDE_SETUP(deferred, defer)
+OVERRIDE_SETUP(critical, critical)
+OVERRIDE_SETUP(disable, disable)
+
+static int __init PrioSetup(char* str)
 {
-    struct init_fn_t* it_init_fnc;      // current init function to execute
-};
+  override_prio = str;
+  return 1;
+}
+__setup("async_minit.prio=", PrioSetup);
 
-int device_open(struct inode * i, struct file * f)
+static int __init ThreadsSetup(char* str)
 {
-    int old = atomic_xchg(&init_done, 1);
-    if (old == 1)
-    {
-        printk(KERN_ERR "deferred init already done");
-        return -EINVAL;      // already done
-    }
-    f->private_data = __async_initcall_start;
-    return 0;
+  override_threads = simple_strtoul(str, NULL, 10);
+  return 1;
 }
+__setup("async_minit.threads=", ThreadsSetup);
 
-static ssize_t device_read(struct file *file, char __user *buf,size_t nbytes, loff_t *ppos)
+static int __init GrowSetup(char* str)
 {
-    struct init_fn_t_4* it_init_fnc;
-    const char* initcall_name;
-    size_t count;
-    count = 0;
-    it_init_fnc = (struct init_fn_t_4*)file->private_data;
+  pool_grow = simple_strtoul(str, NULL, 10);
+  return 1;
+}
+__setup("async_minit.grow=", GrowSetup);
 
-    while (it_init_fnc < __async_initcall_end && init_info[it_init_fnc->id].type != deferred)
-        ++it_init_fnc;
-    if (it_init_fnc != __async_initcall_end)
+/*
+ * Types from the table, then the ones given at boot
+ */
+static void __async_minit_init OverrideTypes(void)
+{
+  const char* text;
+  unsigned type;
+  unsigned len;
+  unsigned id;
+  for (id = 0; id < module_last; ++id)
+    info_4[id].type = init_info[id].type;
+  for (type = 0; type <= disable; ++type)
+  {
+    for (text = override_type[type]; text != NULL && *text != 0; text += len + (text[len] == ','))
     {
-        do_one_initcall(it_init_fnc->fnc);
-        initcall_name = getName(it_init_fnc->id);
-        ++it_init_fnc;
-        file->private_data = it_init_fnc;
-        if (initcall_name == 0 || *initcall_name == 0)
-        {
-            initcall_name = ".";
-        }
-        if (nbytes != 0)
-        {
-           count = strlen(initcall_name) + 1;  // including zero to swap with a \n char
-           if (count > nbytes)
-               count = nbytes;
-           copy_to_user(buf,initcall_name,count);
-           if (count > 1)
-               buf[count-1] = '\n';     // if there is only space for one char we do not set \n
-        }
+      len = strcspn(text, ",");
+      id = FindId(text, len, 0);
+      if (id == module_last || init_info[id].type == disable)
+        printk("async_minit: type of %.*s can not be changed\n", len, text);
+      else
+        info_4[id].type = (enum task_type_t)type;
     }
-    else
+  }
+}
+
+/*
+ * name:usecs pairs, a cost that is not a number is ignored and a huge one is clamped
+ */
+static void __async_minit_init OverridePrio(void)
+{
+  const char* text = override_prio;
+  const char* name;
+  char* end;
+  unsigned long cost;
+  unsigned len;
+  unsigned id;
+  while (text != NULL && *text != 0)
+  {
+    name = text;
+    len = strcspn(text, ":,");
+    id = FindId(text, len, 0);
+    text += len;
+    if (*text == ':')
     {
-      if (atomic_dec_and_test(&free_init_ref) )
-               free_initmem();
+      cost = simple_strtoul(text + 1, &end, 10);
+      if (end == text + 1 || (*end != 0 && *end != ','))
+        printk("async_minit.prio: bad cost for %.*s\n", (int)len, name);
+      else if (id != module_last)
+        info_4[id].cost = min(cost, (unsigned long)cost_max);
+      text = end;
     }
-    return count;
+    text += strcspn(text, ",");
+    text += *text == ',';
+  }
 }
 
-static const struct file_operations deferred_initcalls_fops = {
-   .open = device_open, //
-   .read = device_read,
-   //TODO .write = device_write, // write ascii 1 to do all calls in one go
-};
-
-/**
- * Module entry point
+/*
+ * Workers to keep busy with profiled costs, total cost over the longest chain.
+ * Chain cost is the priority without critical boosts
  */
-//static int async_init(void)
-//{
-//  struct task_struct *thr;
-//
-//  current_type = asynchronized;
-//  atomic_inc(&free_init_ref);
-//  thr = kthread_create(do_asynchronized, (void*) (0), "do_type");
-//  kthread_bind(thr, num_online_cpus() - 1);
-//  wake_up_process(thr);
-//  return 0;
-//}
+static void __async_minit_init ProfileThreads(void)
+{
+  unsigned long total = 0;
+  unsigned path = 1;
+  unsigned idx;
+  unsigned id;
+  for (idx = 0; idx < tasks_count; ++idx)
+  {
+    id = task_list[idx]->id;
+    total += 1 + info_4[id].cost;
+    if (info_4[id].prio % critical_boost > path)
+      path = info_4[id].prio % critical_boost;
+  }
+  profile_threads = (total + path - 1) / path;
+  printk_debug("async profile %u records, %u workers\n", profile_records, profile_threads);
+}
+
+/*
+ * Read all information from static memory an expand it to dynamic memory
+ */
+void __async_minit_init FillTasks(const struct init_fn_t_4* begin, const struct init_fn_t_4* end)
+{
+  const struct init_fn_t_4* it;
+  const struct init_fnc_info_4* nfo;
+  const modules_e* parent;
+  unsigned id;
+  unsigned idx;
+  unsigned edges;
+  unsigned criticals = 0;
+  unsigned generics = 0;
+  unsigned deferreds = 0;
+  memset((void*)info_4, 0, sizeof(info_4));      //clear all status information
+  tasks_end = end;
+  tasks_count = 0;
+  atomic_set(&first_waiting, 0);
+  OverrideTypes();
+  FindAbsent();
+  for (idx = 0; init_cost[idx].id != none_id; ++idx)
+    info_4[init_cost[idx].id].cost = init_cost[idx].cost;
+  LoadProfile();
+  OverridePrio();
+  // registered tasks and groups with a registered member are waiting
+  for (it = begin; it != end; ++it)
+  {
+    nfo = &init_info[it->id];
+    if (info_4[it->id].type == disable || (info_4[it->id].absent && pci_prune == prune_disable))
+      continue;         // never executed, nobody waits for it
+    atomic_set(&info_4[it->id].status, st_waiting);
+    info_4[it->id].parts |= 1 << InitPart(it->fnc);
+    if (info_4[it->id].instances++ == 0)
+      task_list[tasks_count++] = it;
+    if (nfo->grp_id != grp_none_id)
+      atomic_set(&info_4[nfo->grp_id].status, st_waiting);
+  }
+  // update child and parent reference counters, group counts its members
+  for (id = 0; id < module_last; ++id)
+  {
+    if (!IsTask(id))
+      continue;
+    nfo = &init_info[id];
+    for (parent = &init_parents[nfo->parents]; parent != &init_parents[nfo->parents + nfo->parents_count]; ++parent)
+      CountEdge(*parent, (modules_e)id);
+    CountEdge((modules_e)id, nfo->grp_id);
+  }
+  // child_first[id] points to the end of id children, filling backward leaves it at the beginning
+  edges = 0;
+  for (id = 0; id < module_last; ++id)
+  {
+    edges += info_4[id].child_count;
+    child_first[id] = edges;
+  }
+  child_first[module_last] = edges;
+  for (id = module_last; id-- != 0;)
+  {
+    if (!IsTask(id))
+      continue;
+    nfo = &init_info[id];
+    for (parent = &init_parents[nfo->parents]; parent != &init_parents[nfo->parents + nfo->parents_count]; ++parent)
+      PutEdge(*parent, (modules_e)id);
+    PutEdge((modules_e)id, nfo->grp_id);
+  }
+  tasks_filled = local_clock();
+  for (idx = 0; idx < tasks_count; ++idx)
+  {
+    TaskPriority(task_list[idx]->id);
+    if (atomic_read(&info_4[task_list[idx]->id].ref) == 0)
+      task_time[task_list[idx]->id].ready = tasks_filled;
+  }
+  SortTasks();
+  if (profile_records != 0)
+    ProfileThreads();
+  atomic_set(&info_4[none_id].status, st_done);
+  atomic_set(&info_4[grp_none_id].status, st_done);
+  for (id = 0; id < module_last; ++id)
+  {
+    if (info_4[id].type == disable && atomic_read(&info_4[id].status) != st_waiting)
+    {
+      task_time[id].ret = -ENODEV;      // group without registered member
+      smp_wmb();
+      WRITE_ONCE(task_time[id].end, tasks_filled);
+    }
+    else if (info_4[id].type == disable)
+      WRITE_ONCE(task_time[id].end, 0);
+  }
+  for (idx = 0; idx < tasks_count; ++idx)
+  {
+    id = task_list[idx]->id;
+    info_4[id].task_idx = idx;
+    if (info_4[id].type == critical)
+      ++criticals;
+    if (info_4[id].parts & (1 << part_generic))
+      ++generics;
+    if (info_4[id].parts & (1 << part_deferred))
+      ++deferreds;
+  }
+  atomic_set(&critical_left, criticals);
+  if (criticals == 0)
+    complete_all(&critical_done);
+  atomic_set(&generic_left, generics);
+  if (generics == 0)
+    async_minit_release_init();
+  atomic_set(&deferred_left, deferreds);
+  if (deferreds == 0)
+    FreeInitPart(part_deferred);
+}
+
+/*
+ * Task can be executed in current stage when all its parents are done,
+ * deferred stage also takes asynchronized tasks that were waiting for a deferred one or absent.
+ * Critical tasks and their parents of any type run in asynchronized stage
+ */
+static inline int TaskReady(const struct init_fn_t_4* it)
+{
+  if (atomic_read(&info_4[it->id].status) != st_waiting)
+    return 0;
+  if (READ_ONCE(current_type) == asynchronized && (info_4[it->id].type != asynchronized || info_4[it->id].absent)
+      && info_4[it->id].prio < critical_boost)
+    return 0;
+  return atomic_read(&info_4[it->id].ref) == 0;
+}
+
+/*
+ * Record start and end of an initcall
+ */
+static inline void TimeStart(modules_e id, unsigned worker)
+{
+  task_time[id].start = local_clock();
+  task_time[id].cpu = raw_smp_processor_id();
+  task_time[id].worker = worker;
+}
+
+static inline void TimeEnd(modules_e id, int ret)
+{
+  task_time[id].end = local_clock();
+  task_time[id].ret = ret;
+}
+
+/*
+ * Execute task, some init functions share the same name (init) and id,
+ * they are all executed by the thread that takes the first one.
+ * Return the first error
+ */
+static int RunTask(const struct init_fn_t_4* it, unsigned worker)
+{
+  const struct init_fn_t_4* same;
+  unsigned count = info_4[it->id].instances;
+  int ret;
+  int same_ret;
+  TimeStart(it->id, worker);
+  ret = do_one_initcall(it->fnc);
+  for (same = it + 1; count > 1 && same != tasks_end; ++same)
+  {
+    if (same->id == it->id)
+    {
+      same_ret = do_one_initcall(same->fnc);
+      if (ret >= 0)
+        ret = same_ret;      // first error of all
+      --count;
+    }
+  }
+  TimeEnd(it->id, ret);
+  return ret;
+}
+
+/*
+ * Move first_waiting over done tasks, any thread can do it, only one wins every step
+ */
+static void UpdateFirstWaiting(void)
+{
+  unsigned first = atomic_read(&first_waiting);
+  unsigned status;
+  while (first < tasks_count)
+  {
+    status = atomic_read(&info_4[task_list[first]->id].status);
+    if (status == st_waiting || status == st_running)
+      break;
+    atomic_cmpxchg(&first_waiting, first, first + 1);
+    first = atomic_read(&first_waiting);
+  }
+}
+
+/*
+ * Empty deques for the working threads of a stage, worker_cpu is set for them
+ */
+static void InitDeques(unsigned count)
+{
+  unsigned idx;
+  for (idx = 0; idx < module_last; ++idx)
+    info_4[idx].owner = 0;
+  for (idx = 0; idx < count; ++idx)
+  {
+    spin_lock_init(&per_cpu(ready_deque, worker_cpu[idx]).lock);
+    per_cpu(ready_deque, worker_cpu[idx]).head = 0;
+    per_cpu(ready_deque, worker_cpu[idx]).tail = 0;
+  }
+  deques_count = count;
+}
+
+/*
+ * Push a ready task to a working thread deque, return 0 when there is no room or no deque
+ */
+static int PushReady(unsigned worker, modules_e id)
+{
+  struct ready_deque_t_4* dq;
+  int pushed = 0;
+  if (worker >= workers_max || deques_count == 0)
+    return 0;           // reader, demand
+  dq = &per_cpu(ready_deque, worker_cpu[worker]);
+  spin_lock(&dq->lock);
+  if (dq->head - dq->tail < deque_size)
+  {
+    WRITE_ONCE(info_4[id].owner, worker + 1);
+    dq->task[dq->head++ % deque_size] = id;
+    pushed = 1;
+  }
+  spin_unlock(&dq->lock);
+  return pushed;
+}
+
+/*
+ * Take a task from the deque of a cpu, the newest one by its owner or the oldest one by a thief.
+ * Entries already taken by the task list scan or a demand are dropped
+ */
+static const struct init_fn_t_4* PopReady(unsigned cpu, int steal)
+{
+  struct ready_deque_t_4* dq = &per_cpu(ready_deque, cpu);
+  const struct init_fn_t_4* it = NULL;
+  modules_e id;
+  spin_lock(&dq->lock);
+  while (it == NULL && dq->head != dq->tail)
+  {
+    id = steal ? dq->task[dq->tail++ % deque_size] : dq->task[--dq->head % deque_size];
+    if (atomic_cmpxchg(&info_4[id].status, st_waiting, st_running) == st_waiting)
+      it = task_list[info_4[id].task_idx];
+  }
+  spin_unlock(&dq->lock);
+  return it;
+}
+
+/*
+ * Take a ready task, own deque first, then the first one starting from first_waiting
+ * not held by a deque and at last the oldest one of other deques.
+ * Return NULL when nothing is ready
+ */
+static const struct init_fn_t_4* ClaimTask(unsigned worker)
+{
+  const struct init_fn_t_4* it;
+  unsigned idx;
+  if (worker < workers_max && deques_count != 0)
+  {
+    it = PopReady(worker_cpu[worker], 0);
+    if (it != NULL)
+      return it;
+  }
+  for (idx = atomic_read(&first_waiting); idx < tasks_count; ++idx)
+  {
+    it = task_list[idx];
+    if (READ_ONCE(info_4[it->id].owner) == 0 && TaskReady(it) && atomic_cmpxchg(&info_4[it->id].status, st_waiting, st_running) == st_waiting)
+      return it;
+  }
+  for (idx = 1; idx <= deques_count; ++idx)
+  {
+    it = PopReady(worker_cpu[(worker + idx) % deques_count], 1);
+    if (it != NULL)
+      return it;
+  }
+  return NULL;
+}
+
+/*
+ * Tasks ready and not taken yet, in deques or in the task list
+ */
+static unsigned ReadyCount(void)
+{
+  unsigned count = 0;
+  unsigned idx;
+  for (idx = atomic_read(&first_waiting); idx < tasks_count; ++idx)
+  {
+    if (TaskReady(task_list[idx]))
+      ++count;
+  }
+  return count;
+}
+
+/*
+ * Take a task for a working thread.
+ * Return NULL when nothing is ready, gen gets the list generation to wait for changes.
+ * The calling thread stops being active when nothing is ready, the last one going out
+ * without any task done during its search finishes the stage.
+ */
+static const struct init_fn_t_4* PeekTask(unsigned worker, unsigned* gen)
+{
+  const struct init_fn_t_4* it;
+  *gen = atomic_read(&list_gen);
+  it = ClaimTask(worker);
+  if (it != NULL)
+    return it;
+  if (atomic_dec_return(&threads_active) == 0 && (unsigned)atomic_read(&list_gen) == *gen)
+    WRITE_ONCE(stage_done, 1);
+  if ((unsigned)atomic_read(&first_waiting) == tasks_count)
+    WRITE_ONCE(stage_done, 1);     // all task done
+  return NULL;
+}
+
+/*
+ * Group is over when its last member is done or when one fails. The result is kept in task_time,
+ * waiters can read it after init memory is released
+ */
+static void GroupOver(modules_e id, int ret)
+{
+  task_time[id].ret = ret;
+  smp_wmb();      // ret is visible before end
+  WRITE_ONCE(task_time[id].end, local_clock());
+  atomic_inc(&groups_gen);
+  wake_up_interruptible_all(&group_wait);
+}
+
+/*
+ * Release children of a done task or group, only direct children are touched.
+ * A group is done when its last member is done, then its own children are released.
+ * Children ready in current stage go to the deque of the working thread that did the parent.
+ * Return how many tasks became ready
+ */
+static unsigned __ref ReleaseChildren(modules_e id, unsigned worker)
+{
+  unsigned released = 0;
+  unsigned idx;
+  modules_e child;
+  for (idx = child_first[id]; idx != child_first[id + 1]; ++idx)
+  {
+    child = child_list[idx];
+    if (!atomic_dec_and_test(&info_4[child].ref))
+      continue;
+    if (atomic_read(&info_4[child].status) != st_waiting)
+      continue;         // skipped by another parent
+    if (info_4[child].type == disable)
+    {
+      if (atomic_cmpxchg(&info_4[child].status, st_waiting, st_done) == st_waiting)     // group
+      {
+        GroupOver(child, 0);
+        released += ReleaseChildren(child, worker);
+      }
+    }
+    else
+    {
+      task_time[child].ready = local_clock();
+      if (TaskReady(task_list[info_4[child].task_idx]))
+        PushReady(worker, child);
+      ++released;
+    }
+  }
+  return released;
+}
+
+/*
+ * A task is over, done or not. The last critical one lets root file system be mounted,
+ * the last one with code in an init memory part releases it
+ */
+static void TaskOver(modules_e id, int ret)
+{
+  if (info_4[id].type == critical && atomic_dec_and_test(&critical_left))
+    complete_all(&critical_done);
+#ifdef CONFIG_ASYNCHRO_MODULE_INIT_RETRY
+  if (ret < 0 && READ_ONCE(current_type) == asynchronized)
+    return;         // it runs again in deferred stage
+#endif
+  if ((info_4[id].parts & (1 << part_generic)) && atomic_dec_and_test(&generic_left))
+    async_minit_release_init();
+  if ((info_4[id].parts & (1 << part_deferred)) && atomic_dec_and_test(&deferred_left))
+    FreeInitPart(part_deferred);
+}
+
+/*
+ * Skip all tasks depending on a failed one, a group with a failed member is failed too.
+ * Nothing is released, children are not executed
+ */
+static void __ref SkipChildren(modules_e id, int ret)
+{
+  unsigned idx;
+  modules_e child;
+  for (idx = child_first[id]; idx != child_first[id + 1]; ++idx)
+  {
+    child = child_list[idx];
+    if (atomic_cmpxchg(&info_4[child].status, st_waiting, st_skipped) != st_waiting)
+      continue;         // already skipped
+    info_4[child].ret = ret;
+    printk_debug("async %s skipped\n", getName(child));
+    if (info_4[child].type == disable)
+      GroupOver(child, ret);
+    TaskOver(child, ret);
+    SkipChildren(child, ret);
+  }
+}
+
+/*
+ * Set task as done and release its children, when it failed all its dependents are skipped.
+ * Wake up as many threads as tasks became ready
+ */
+static void TaskDone(const struct init_fn_t_4* it, int ret)
+{
+  unsigned released = 0;
+  info_4[it->id].ret = ret;
+  if (ret < 0)
+  {
+    printk_debug("async %s returned %d\n", getName(it->id), ret);
+    atomic_set(&info_4[it->id].status, st_failed);
+    SkipChildren(it->id, ret);
+  }
+  else
+  {
+    atomic_set(&info_4[it->id].status, st_done);
+    released = ReleaseChildren(it->id, task_time[it->id].worker);
+  }
+  TaskOver(it->id, ret);
+  UpdateFirstWaiting();
+  atomic_inc_return(&list_gen);     // full barrier, status is visible before generation
+  wake_up_interruptible_all(&demand_wait);
+  if ((unsigned)atomic_read(&first_waiting) == tasks_count)
+  {
+    // last one, idle working threads and the reader have nothing to wait for
+    WRITE_ONCE(stage_done, 1);
+    wake_up_interruptible_all(&list_wait);
+  }
+  else if (released != 0)
+    wake_up_interruptible_nr(&list_wait, released);
+}
+
+/*
+ * Watch a task run by a working thread, replacements beyond workers_max are not watched
+ */
+static inline void WatchStart(unsigned worker, modules_e id)
+{
+  unsigned msecs = overdue_msecs[info_4[id].type];
+  if (worker >= workers_max)
+    return;
+  WRITE_ONCE(worker_watch[worker].deadline, msecs != 0 ? local_clock() + msecs * 1000000ULL : ~0ULL);
+  smp_wmb();      // deadline is visible before the task
+  atomic_set(&worker_watch[worker].task, id + 1);
+}
+
+/*
+ * Return 0 when the thread was written off while running id
+ */
+static inline int WatchEnd(unsigned worker, modules_e id)
+{
+  if (worker >= workers_max)
+    return 1;
+  return atomic_cmpxchg(&worker_watch[worker].task, id + 1, 0) == id + 1;
+}
+
+static void OverdueDone(const struct init_fn_t_4* it, int ret, unsigned worker);
+
+/*
+ * Deferred stage in background, kernel_init starts it when it hands over to userspace and budget is not 0.
+ * Its threads run at SCHED_IDLE, before taking a task a thread sleeps while initcalls took more than
+ * budget percent of one cpu since the stage started or while more threads are runnable than cpus
+ */
+enum { background_period = 20 };                                           // msecs between checks
+static unsigned background_budget = CONFIG_ASYNCHRO_MODULE_INIT_BACKGROUND;  // percent of one cpu, 0 off
+static int background_stage;                                               // current stage is in background
+static u64 background_start;
+static atomic_t background_busy = ATOMIC_INIT(0);                          // usecs spent in initcalls
+
+static int __init BackgroundSetup(char* str)
+{
+  background_budget = simple_strtoul(str, NULL, 10);
+  return 1;
+}
+__setup("async_minit.background=", BackgroundSetup);
+
+static void BackgroundEnter(void)
+{
+  struct sched_param param = { .sched_priority = 0 };
+  sched_setscheduler_nocheck(current, SCHED_IDLE, &param);
+}
+
+/*
+ * Wait until the budget allows another initcall and the run queue is not busy
+ */
+static void BackgroundThrottle(void)
+{
+  u64 elapsed;
+  for (;;)
+  {
+    elapsed = div_u64(local_clock() - background_start, 1000);
+    if ((u64)atomic_read(&background_busy) * 100 <= elapsed * background_budget && nr_running() <= num_online_cpus())
+      return;
+    msleep(background_period);
+  }
+}
 
 /**
- * Register proc entry to allow deferred initialization
+ * Thread for version 2
  */
-static int async_init(void)
+
+int  ProcessThread2(void *data)
+{
+    int ret;
+    unsigned gen;
+    const struct init_fn_t_4* it;
+    printk_debug("async %lu starts\n", (unsigned long)data);
+    if (READ_ONCE(background_stage))
+        BackgroundEnter();
+    if ((unsigned long)data < workers_max)
+        WRITE_ONCE(worker_watch[(unsigned long)data].thread, current);
+    atomic_inc(&threads_active);
+    for (;;)
+    {
+        if (READ_ONCE(background_stage))
+            BackgroundThrottle();
+        it = PeekTask((unsigned long)data, &gen);
+        if (it == NULL)
+        {
+            if (READ_ONCE(stage_done))
+                break;
+            // something is running, its completion can release a child or finish the stage
+            ret = wait_event_interruptible_exclusive(list_wait, (unsigned)atomic_read(&list_gen) != gen || READ_ONCE(stage_done));
+            if (ret != 0)
+            {
+                printk("async init wake up returned %d\n", ret);
+                break;
+            }
+            atomic_inc(&threads_active);
+            continue;
+        }
+        printk_debug("async %lu %pF %s\n", (unsigned long)data, it->fnc, getName(it->id));
+        WatchStart((unsigned long)data, it->id);
+        ret = RunTask(it, (unsigned long)data);
+        if (!WatchEnd((unsigned long)data, it->id))
+        {
+            OverdueDone(it, ret, (unsigned long)data);
+            return 0;       // written off, out of stage accounting
+        }
+        if (READ_ONCE(background_stage))
+            atomic_add((int)div_u64(task_time[it->id].end - task_time[it->id].start, 1000), &background_busy);
+        TaskDone(it, ret);
+        schedule();        // give time to system to do other things
+    }
+    printk_debug("async %lu ends\n", (unsigned long)data);
+    wake_up_interruptible_all(&list_wait);      // stage done, nobody has to wait
+    wake_up_interruptible_all(&watch_wait);
+    if (atomic_dec_and_test(&threads_running))
+        wake_up_interruptible_all(&list_wait);
+    return 0;
+}
+
+/*
+ * Write off a working thread running an overdue task, a replacement is started in its place.
+ * The replacement is created first, nothing changes when the task returned meanwhile
+ */
+static void WriteOff(unsigned worker, unsigned task)
+{
+  struct task_struct *thr;
+  unsigned replacement = atomic_read(&workers_count);
+  if (replacement >= workers_max)
+    return;         // no watch slot left, the stall is waited for
+  thr = kthread_create(ProcessThread2, (void* )(unsigned long)(replacement), "async_thread_%d", replacement);
+  if (IS_ERR(thr))
+    return;
+  if ((unsigned)atomic_cmpxchg(&worker_watch[worker].task, task, task | overdue_flag) != task)
+  {
+    kthread_stop(thr);
+    return;
+  }
+  printk("async %s overdue, thread %u written off\n", getName((modules_e)(task - 1)), worker);
+  worker_cpu[replacement] = worker_cpu[worker];
+  atomic_inc(&tasks_overdue);
+  atomic_inc(&workers_count);
+  // the replacement is alive in place of the written off thread, it is active from its start
+  atomic_dec(&threads_active);
+  wake_up_process(thr);
+}
+
+/*
+ * Add a working thread to the current stage, it shares a deque. Return 0 when it can not be started
+ */
+static int AddWorker(void)
+{
+  struct task_struct *thr;
+  unsigned worker = atomic_read(&workers_count);
+  if (worker >= workers_max)
+    return 0;
+  thr = kthread_create(ProcessThread2, (void* )(unsigned long)(worker), "async_thread_%d", worker);
+  if (IS_ERR(thr))
+    return 0;
+  worker_cpu[worker] = worker_cpu[worker % deques_count];
+  atomic_inc(&workers_count);
+  atomic_inc(&workers_added);
+  atomic_inc(&threads_running);
+  wake_up_process(thr);
+  return 1;
+}
+
+/*
+ * Add threads while tasks are ready, every thread is taken and a cpu is idle, up to twice pool_width.
+ * Threads blocked in their task are not counted, background stage keeps its threads
+ */
+static void GrowPool(void)
+{
+  struct task_struct* thr;
+  unsigned worker;
+  unsigned task;
+  unsigned ready;
+  int blocked = 0;
+  int busy;
+  long idle;
+  if (!pool_grow || READ_ONCE(background_stage))
+    return;
+  // threads started and not active yet count as parked, one more is added when they take their tasks
+  if (atomic_read(&threads_active) != atomic_read(&threads_running) - 1)
+    return;
+  rcu_read_lock();        // a thread going out now is not freed before the grace period
+  for (worker = 0; worker < (unsigned)atomic_read(&workers_count) && worker < workers_max; ++worker)
+  {
+    task = atomic_read(&worker_watch[worker].task);
+    thr = READ_ONCE(worker_watch[worker].thread);
+    if (task != 0 && (task & overdue_flag) == 0 && thr != NULL && READ_ONCE(thr->state) != TASK_RUNNING)
+      ++blocked;
+  }
+  rcu_read_unlock();
+  busy = atomic_read(&threads_active) - blocked;
+  idle = (long)num_online_cpus() - (long)nr_running();      // the watchdog is running, one cpu is left free
+  for (ready = ReadyCount(); ready != 0 && busy < (int)pool_width && idle > 0
+      && (unsigned)atomic_read(&threads_running) < 2 * pool_width + 1; --ready, ++busy, --idle)
+  {
+    if (!AddWorker())
+      break;
+  }
+}
+
+/*
+ * Check running tasks and grow the pool every watch_period until the stage is done
+ */
+static int Watchdog(void* d)
+{
+  unsigned worker;
+  unsigned task;
+  while (!READ_ONCE(stage_done))
+  {
+    wait_event_interruptible_timeout(watch_wait, READ_ONCE(stage_done), msecs_to_jiffies(watch_period));
+    for (worker = 0; worker < (unsigned)atomic_read(&workers_count) && worker < workers_max; ++worker)
+    {
+      task = atomic_read(&worker_watch[worker].task);
+      smp_rmb();      // deadline of that task
+      if (task != 0 && (task & overdue_flag) == 0 && local_clock() > READ_ONCE(worker_watch[worker].deadline))
+        WriteOff(worker, task);
+    }
+    if (!READ_ONCE(stage_done))
+      GrowPool();
+  }
+  if (atomic_dec_and_test(&threads_running))
+    wake_up_interruptible_all(&list_wait);
+  return 0;
+}
+
+/*
+ * Watchdog runs with the working threads of a stage,
+ * without it a stall only blocks its thread and the pool keeps its first threads
+ */
+static void StartWatchdog(void)
 {
-  // print full list
-  const struct init_fn_t_4* it_init_fnc;
   struct task_struct *thr;
+  thr = kthread_create(Watchdog, NULL, "async_watchdog");
+  if (IS_ERR(thr))
+    return;
+  atomic_inc(&threads_running);
+  wake_up_process(thr);
+}
 
-//    for (it_init_fnc = __async_initcall_start; it_init_fnc < __async_initcall_end; ++it_init_fnc)
-//    {
-//      printk("%s %d \n",getName(it_init_fnc->id),init_info[it_init_fnc->id].type);
-//    }
+/**
+ * Execute all initialization for an specific type
+ * We need wait for everything done as a barrier to avoid problems
+ */
+int  start_threads(int(* thread_fnc) (void*) )
+{
+    // leave one cpu free, do_asynchronized and the rest of the system run on the last one
+    unsigned free_cpus = num_online_cpus() > 1 ? num_online_cpus() - 1 : 1;
+    unsigned max_cpus = free_cpus;
+    unsigned it;
+    unsigned cpu;
+    struct task_struct *thr;
+    if (CONFIG_ASYNCHRO_MODULE_INIT_THREADS != 0 && max_cpus > CONFIG_ASYNCHRO_MODULE_INIT_THREADS)
+    {
+        max_cpus = CONFIG_ASYNCHRO_MODULE_INIT_THREADS;
+    }
+    if (profile_threads != 0 && max_cpus > profile_threads)
+        max_cpus = profile_threads;
+    if (override_threads != 0)
+        max_cpus = min(free_cpus, override_threads);
+    // validated cpu count
+    if (max_cpus == 0)
+        max_cpus = 1;
+    if (max_cpus > workers_max)
+        max_cpus = workers_max;
+    // the watchdog adds more when threads sleep in their tasks
+    pool_width = max_cpus;
 
-    atomic_inc(&free_init_ref);
-    //atomic_inc(&free_init_ref);
+    printk_debug("async using %d cpus\n", max_cpus);
+    // working threads take the first online cpus, the last one is left free
+    it = 0;
+    for_each_online_cpu(cpu)
+    {
+        if (it == max_cpus)
+            break;
+        worker_cpu[it++] = cpu;
+    }
+    while (it < max_cpus)
+        worker_cpu[it++] = worker_cpu[0];     // cpus gone offline meanwhile
+    InitDeques(max_cpus);
+    atomic_set(&workers_count, max_cpus);
+    for (it=0; it < max_cpus;  ++it)
+    {
+        //start working threads
+        atomic_inc(&threads_running);
+        thr = kthread_create(thread_fnc, (void* )(unsigned long)(it), "async_thread_%d",it);
+        if (!IS_ERR(thr))
+        {
+            kthread_bind(thr, worker_cpu[it]);
+            wake_up_process(thr);
+        }
+        else
+        {
+            printk("Async module initialization thread failed .. fall back to normal mode");
+            thread_fnc((void* )(unsigned long)(it));
+        }
+    }
+    return 0;
+}
+
+/*
+ * Run a stage on working threads, return when all of them are gone
+ */
+static void RunStage(enum task_type_t type)
+{
+    WRITE_ONCE(current_type, type);
+    stage_done = 0;
+    start_threads(ProcessThread2);
+    StartWatchdog();
+    wait_event(list_wait, atomic_read(&threads_running) == 0);
+}
+
+static atomic_t deferred_started = ATOMIC_INIT(0);     // deferred stage on working threads, 1 running 2 done
+static atomic_t deferred_done = ATOMIC_INIT(0);        // all tasks done, init memory released
+static atomic_t demand_ready = ATOMIC_INIT(0);         // task list filled, open can trigger initialization
+static DEFINE_MUTEX(demand_lock);                      // one demand at a time, failed tasks are not reset under it
+// current module
+
+
+
+/*
+ * wait for asynchronized stage to be done, -ERESTARTSYS when a signal came first
+ * todo use a global counter equal to 2 to known when all stages are done (asyn,deferred) use a wait queue for notification
+ */
+static inline int wait_(void)
+{
+    return wait_event_interruptible(list_wait, READ_ONCE(current_type) != asynchronized);
+}
+
+/**
+ * Module initialization is taking a long time, more than any other.
+ * Module initialization and fist execution is going to be do from thread
+ */
+
+/*
+ * Run every ready task in the calling thread
+ */
+static void RunReady(unsigned worker)
+{
+    const struct init_fn_t_4* it;
+    while ((it = ClaimTask(worker)) != NULL)
+        TaskDone(it, RunTask(it, worker));
+}
+
+/*
+ * Called when deferred stage can be finished, by working threads or by the reader.
+ * Only the first one with every task done and no working thread alive finishes it,
+ * init memory is released
+ */
+static void DeferredDone(void)
+{
+    if ((unsigned)atomic_read(&first_waiting) != tasks_count)
+        return;         // the reader is still running something
+    if (atomic_read(&deferred_started) == 1)
+        return;         // DeferredStage finishes it when its threads are gone
+    if (atomic_xchg(&deferred_done, 1) != 0)
+        return;
+    WRITE_ONCE(current_type, end);
+    wake_up_interruptible_all(&list_wait);
+    if (atomic_dec_and_test(&scheduler_ref))
+        FreeInitPart(part_scheduler);
+}
+
+/*
+ * Run deferred stage on working threads, it starts when asynchronized one is done.
+ * Interrupted before it starts, it is left to a later write
+ */
+static int DeferredStage(void* d)
+{
+    if (wait_() != 0)
+    {
+        atomic_set(&deferred_started, 0);
+        return -ERESTARTSYS;
+    }
+    RunStage(deferred);
+    atomic_xchg(&deferred_started, 2);     // full barrier, an overdue task returning now sees it
+    RunReady(worker_reader);
+    DeferredDone();
+    return 0;
+}
+
+/*
+ * Deferred stage at idle priority under the cpu budget, it is finished like one started by a write
+ */
+static int BackgroundStage(void* d)
+{
+    BackgroundEnter();
+    if (wait_() != 0)
+    {
+        atomic_set(&deferred_started, 0);
+        return -ERESTARTSYS;
+    }
+    background_start = local_clock();
+    atomic_set(&background_busy, 0);
+    WRITE_ONCE(background_stage, 1);
+    DeferredStage(d);
+    WRITE_ONCE(background_stage, 0);
+    return 0;
+}
+
+/*
+ * Overdue task returned in its written off thread. Its dependents run on working threads of current stage,
+ * after deferred stage nothing else runs them and the thread does it
+ */
+static void OverdueDone(const struct init_fn_t_4* it, int ret, unsigned worker)
+{
+    printk("async %s returned %d overdue\n", getName(it->id), ret);
+    TaskDone(it, ret);
+    if (atomic_read(&deferred_started) != 2)
+        return;
+    RunReady(worker);
+    DeferredDone();
+}
+
+
+#ifdef CONFIG_ASYNCHRO_MODULE_INIT_RETRY
+/*
+ * Failed tasks and their dependents are waiting again, a parent may be missing something
+ * that deferred stage brings (firmware, root file system).
+ * Reference counters are kept, they count parents that did not release their children:
+ * failed and skipped ones never do and a task written off as overdue does when it returns
+ */
+static void __ref RetryFailed(void)
+{
+  unsigned id;
+  unsigned status;
+  for (id = 0; id < module_last; ++id)
+  {
+    status = atomic_read(&info_4[id].status);
+    if (status == st_failed || status == st_skipped)
+    {
+      info_4[id].ret = 0;
+      atomic_set(&info_4[id].status, st_waiting);
+      if (info_4[id].type == disable)
+        WRITE_ONCE(task_time[id].end, 0);     // group is waiting again
+    }
+  }
+  atomic_set(&first_waiting, 0);
+  UpdateFirstWaiting();
+}
+#endif
+
+/**
+ * Run all asynchronized tasks on working threads following dependencies
+ */
+int __ref do_asynchronized(void* d)
+{
+    FillTasks(__async_initcall_start, __async_initcall_end);
+    atomic_inc_return(&demand_ready);     // full barrier, task list is visible before demands
+    RunStage(asynchronized);
+#ifdef CONFIG_ASYNCHRO_MODULE_INIT_RETRY
+    mutex_lock(&demand_lock);
+    RetryFailed();
+    mutex_unlock(&demand_lock);
+#endif
+    // asynchronized tasks waiting for a deferred one are left to deferred stage
+    WRITE_ONCE(current_type, deferred);
+    wake_up_interruptible_all(&list_wait);
+//    if (atomic_dec_and_test(&free_init_ref) )
+//             free_initmem();
+    return 0;
+}
+
+/*
+ * Run a task now in the calling thread with all its parents, any stage.
+ * A group runs all its members. Task running in another thread is waited for.
+ * Return 0 when done, task or parent error, -ENODEV when it is not registered
+ */
+static int __ref DemandTask(modules_e id)
+{
+  const struct init_fn_t_4* it;
+  const modules_e* parent;
+  unsigned idx;
+  int ret;
+  for (;;)
+  {
+    switch (atomic_read(&info_4[id].status))
+    {
+    case st_waiting:
+      break;
+    case st_running:
+      if (wait_event_interruptible(demand_wait, atomic_read(&info_4[id].status) != st_running))
+        return -ERESTARTSYS;
+      continue;
+    case st_done:
+      return 0;
+    case st_disable:
+      return -ENODEV;
+    default:
+      return info_4[id].ret;      // failed or skipped
+    }
+    if (info_4[id].type == disable)
+    {
+      for (idx = 0; idx < module_last; ++idx)
+      {
+        if (init_info[idx].grp_id == id && info_4[idx].type != disable && DemandTask((modules_e)idx) == -ERESTARTSYS)
+          return -ERESTARTSYS;
+      }
+      // last member done releases the group
+      if (wait_event_interruptible(demand_wait, atomic_read(&info_4[id].status) != st_waiting))
+        return -ERESTARTSYS;
+      continue;
+    }
+    for (parent = &init_parents[init_info[id].parents]; parent != &init_parents[init_info[id].parents + init_info[id].parents_count]; ++parent)
+    {
+      if (*parent != none_id && *parent != grp_none_id && DemandTask(*parent) == -ERESTARTSYS)
+        return -ERESTARTSYS;
+    }
+    // a parent done by another thread may be still releasing its children
+    if (wait_event_interruptible(demand_wait, atomic_read(&info_4[id].ref) == 0 || atomic_read(&info_4[id].status) != st_waiting))
+      return -ERESTARTSYS;
+    // counted as active before it is taken, working threads do not finish the stage while it runs
+    atomic_inc(&threads_active);
+    if (atomic_cmpxchg(&info_4[id].status, st_waiting, st_running) != st_waiting)
+    {
+      // taken by a working thread or skipped, a parked thread may be the last one to finish the stage
+      atomic_dec(&threads_active);
+      wake_up_interruptible_all(&list_wait);
+      continue;
+    }
+    it = task_list[info_4[id].task_idx];
+    printk_debug("async demand %s\n", getName(id));
+    ret = RunTask(it, worker_demand);
+    TaskDone(it, ret);
+    atomic_dec(&threads_active);
+    wake_up_interruptible_all(&list_wait);
+    return ret < 0 ? ret : 0;
+  }
+}
+
+/*
+ * Run all modules serving a device node or a class, or a module by name.
+ * Init memory is kept while running, nothing is done once it is released.
+ * Return first error, -ENODEV when nothing is known for it
+ */
+static int __ref Demand(char type, unsigned major, const char* name)
+{
+  unsigned idx;
+  int found = 0;
+  int ret = 0;
+  int err;
+  if (atomic_read(&demand_ready) == 0 || !atomic_inc_not_zero(&scheduler_ref))
+    return 0;
+  mutex_lock(&demand_lock);
+  for (idx = 0; init_devices[idx].id != none_id && ret != -ERESTARTSYS; ++idx)
+  {
+    if (name != NULL && strcmp(init_devices[idx].name, name) != 0)
+      continue;
+    if (name == NULL && (init_devices[idx].type != type || init_devices[idx].major != major))
+      continue;
+    found = 1;
+    err = DemandTask(init_devices[idx].id);
+    if (ret == 0 && err < 0 && err != -ENODEV)
+      ret = err;        // modules not registered are fine, others can serve it
+  }
+  for (idx = 0; name != NULL && !found && idx < module_last; ++idx)
+  {
+    if (strcmp(getName((modules_e)idx), name) == 0)
+    {
+      found = 1;
+      ret = DemandTask((modules_e)idx);
+    }
+  }
+  mutex_unlock(&demand_lock);
+  if (atomic_dec_and_test(&scheduler_ref))
+    FreeInitPart(part_scheduler);
+  return found ? ret : -ENODEV;
+}
+
+/*
+ * Called on open of a device node without driver, before trying to load a module for it:
+ * from base_probe for unregistered majors, from misc_open and snd_open for minors of their majors
+ */
+int async_minit_demand_dev(char type, unsigned major)
+{
+  return Demand(type, major, NULL);
+}
+EXPORT_SYMBOL(async_minit_demand_dev);
+
+/*
+ * Run modules of a class (sound, input, block ..) or a single module by its init function name
+ */
+int async_minit_demand_name(const char* name)
+{
+  return Demand(0, 0, name);
+}
+EXPORT_SYMBOL(async_minit_demand_name);
+
+/*
+ * Block until every critical task is over, called by kernel_init before prepare_namespace.
+ * It can be called before the task list is filled, nothing is completed until then
+ */
+void async_minit_wait_critical(void)
+{
+  wait_for_completion(&critical_done);
+}
+EXPORT_SYMBOL(async_minit_wait_critical);
+
+/*
+ * Block until a group (grp_usb_id, grp_hid_id ..) is over, it can be called before the task list is filled
+ * and after init memory is released. Return 0 when all its members are done, error of a failed member,
+ * -ENODEV when none is registered
+ */
+int async_minit_wait_group(modules_e id)
+{
+  if (id >= module_last)
+    return -EINVAL;
+  if (wait_event_interruptible(group_wait, READ_ONCE(task_time[id].end) != 0))
+    return -ERESTARTSYS;
+  smp_rmb();
+  return task_time[id].ret;
+}
+EXPORT_SYMBOL(async_minit_wait_group);
+
+/*
+ * kernel_init hands over to userspace, deferred initcalls start in background when a budget is set.
+ * A write to deferred_initcalls meanwhile waits for them to be done
+ */
+void async_minit_background(void)
+{
+  struct task_struct *thr;
+  if (background_budget == 0 || atomic_cmpxchg(&deferred_started, 0, 1) != 0)
+    return;
+  printk("async_minit: deferred initcalls in background, %u%% of a cpu\n", background_budget);
+  thr = kthread_run(BackgroundStage, NULL, "async_background");
+  if (IS_ERR(thr))
+    atomic_set(&deferred_started, 0);     // left to a write
+}
+EXPORT_SYMBOL(async_minit_background);
+
+/*
+ * Structure holding all device file data
+ */
+struct device_t
+{
+    struct init_fn_t* it_init_fnc;      // current init function to execute
+};
+
+/*
+ * Opened any number of times, deferred stage is started once by the first write of 1
+ * and reads are at end of file once everything is done
+ */
+int device_open(struct inode * i, struct file * f)
+{
+    return 0;
+}
+
+/*
+ * Execute one deferred task in the reading process and return its name.
+ * Tasks are taken by priority when their parents are done, working threads
+ * started by a write can run at the same time. End of file when all tasks are done
+ */
+static ssize_t device_read(struct file *file, char __user *buf,size_t nbytes, loff_t *ppos)
+{
+    const struct init_fn_t_4* it;
+    const char* initcall_name;
+    char line[96];
+    ssize_t count;
+    unsigned gen;
+    count = 0;
+
+    // deferred stage starts when asynchronized one is done
+    if (wait_() != 0)
+        return -ERESTARTSYS;
+    if (!atomic_inc_not_zero(&scheduler_ref))
+        return 0;       // everything done, task list is released
+    for (;;)
+    {
+        gen = atomic_read(&list_gen);
+        it = ClaimTask(worker_reader);
+        if (it != NULL || (unsigned)atomic_read(&first_waiting) == tasks_count)
+            break;
+        // working threads are running parents of everything left
+        if (wait_event_interruptible(list_wait, (unsigned)atomic_read(&list_gen) != gen))
+        {
+            count = -ERESTARTSYS;
+            break;
+        }
+    }
+    if (it != NULL)
+    {
+        TaskDone(it, RunTask(it, worker_reader));
+        initcall_name = getName(it->id);
+        if (initcall_name == 0 || *initcall_name == 0)
+        {
+            initcall_name = ".";
+        }
+        if (nbytes != 0)
+        {
+            // the line is built here, the user buffer is only written by copy_to_user
+            count = min(snprintf(line, sizeof(line), "%s\n", initcall_name), (int)sizeof(line) - 1);
+            if ((size_t)count > nbytes)
+            {
+                count = nbytes;
+                if (count > 1)
+                    line[count - 1] = '\n';     // if there is only space for one char we do not set \n
+            }
+            if (copy_to_user(buf, line, count))
+                count = -EFAULT;
+        }
+    }
+    else if (count == 0)
+        DeferredDone();
+    if (atomic_dec_and_test(&scheduler_ref))
+        FreeInitPart(part_scheduler);
+    return count;
+}
+
+/*
+ * Writing 1 runs the whole deferred stage on working threads following dependencies.
+ * Writer waits for all of them unless file is opened with O_NONBLOCK,
+ * a second writer only waits for the first one.
+ * Writing a class or module name runs it now with its parents (echo sound > /proc/deferred_initcalls)
+ */
+static ssize_t device_write(struct file *file, const char __user *buf,size_t nbytes, loff_t *ppos)
+{
+    struct task_struct *thr;
+    char name[64];
+    size_t len;
+    int ret;
+    if (nbytes == 0)
+        return 0;
+    len = nbytes < sizeof(name) ? nbytes : sizeof(name) - 1;
+    if (copy_from_user(name, buf, len))
+        return -EFAULT;
+    name[len] = 0;
+    if (name[len - 1] == '\n')
+        name[len - 1] = 0;
+    if (strcmp(name, "1") != 0)
+    {
+        ret = async_minit_demand_name(name);
+        return ret < 0 ? ret : nbytes;
+    }
+    if (atomic_cmpxchg(&deferred_started, 0, 1) == 0)
+    {
+        if (!(file->f_flags & O_NONBLOCK))
+        {
+            ret = DeferredStage(NULL);
+            return ret < 0 ? ret : nbytes;
+        }
+        thr = kthread_run(DeferredStage, NULL, "async_deferred");
+        if (IS_ERR(thr))
+            DeferredStage(NULL);
+        return nbytes;
+    }
+    if (!(file->f_flags & O_NONBLOCK) && wait_event_interruptible(list_wait, READ_ONCE(current_type) == end))
+        return -ERESTARTSYS;
+    return nbytes;
+}
+
+static const struct file_operations deferred_initcalls_fops = {
+   .open = device_open, //
+   .read = device_read,
+   .write = device_write,
+};
+
+/*
+ * Time records as text, one line for each executed initcall.
+ * *ppos is the line number, 0 is the header and line id + 1 is the record of id
+ */
+static ssize_t times_read(struct file *file, char __user *buf,size_t nbytes, loff_t *ppos)
+{
+    char line[128];
+    const struct task_time_t_4* tm;
+    size_t count = 0;
+    unsigned id;
+    int len;
+    for (id = *ppos; id <= module_last; ++id)
+    {
+        if (id == 0)
+            len = snprintf(line, sizeof(line), "name cpu worker ret ready start end dep_wait\n");
+        else
+        {
+            tm = &task_time[id - 1];
+            if (tm->start == 0)
+                continue;       // not executed
+            len = snprintf(line, sizeof(line), "%s %u %u %d %llu %llu %llu %llu\n", getName((modules_e)(id - 1)),
+                    tm->cpu, tm->worker, tm->ret, (unsigned long long)tm->ready,
+                    (unsigned long long)tm->start, (unsigned long long)tm->end,
+                    (unsigned long long)(tm->ready > tasks_filled ? tm->ready - tasks_filled : 0));
+        }
+        if (count + len > nbytes)
+            break;              // next read takes it
+        if (copy_to_user(buf + count, line, len))
+            return -EFAULT;
+        count += len;
+    }
+    *ppos = id;
+    return count;
+}
+
+/*
+ * Time records as they are in memory, struct task_time_t_4 [module_last] indexed by modules_e
+ */
+static ssize_t times_bin_read(struct file *file, char __user *buf,size_t nbytes, loff_t *ppos)
+{
+    return simple_read_from_buffer(buf, nbytes, ppos, task_time, sizeof(task_time));
+}
+
+static const struct file_operations initcall_times_fops = {
+   .read = times_read,
+};
+
+static const struct file_operations initcall_times_bin_fops = {
+   .read = times_bin_read,
+};
+
+/*
+ * Groups as text, "name state ret" where state is waiting, done or failed.
+ * *ppos is the module id, a read from the start remembers the groups generation for poll
+ */
+static ssize_t groups_read(struct file *file, char __user *buf,size_t nbytes, loff_t *ppos)
+{
+    char line[96];
+    const char* name;
+    size_t count = 0;
+    unsigned id;
+    int len;
+    if (*ppos == 0)
+        file->private_data = (void*)(unsigned long)atomic_read(&groups_gen);
+    for (id = *ppos; id < module_last; ++id)
+    {
+        name = getName((modules_e)id);
+        if (strncmp(name, "grp_", 4) != 0 || id == grp_none_id)
+            continue;
+        if (READ_ONCE(task_time[id].end) == 0)
+            len = snprintf(line, sizeof(line), "%s waiting 0\n", name);
+        else
+        {
+            smp_rmb();
+            len = snprintf(line, sizeof(line), "%s %s %d\n", name, task_time[id].ret == 0 ? "done" : "failed",
+                    task_time[id].ret);
+        }
+        if (count + len > nbytes)
+            break;              // next read takes it
+        if (copy_to_user(buf + count, line, len))
+            return -EFAULT;
+        count += len;
+    }
+    *ppos = id;
+    return count;
+}
+
+/*
+ * Readable again when a group is over since the last read from the start
+ */
+static unsigned int groups_poll(struct file *file, poll_table *wait)
+{
+    poll_wait(file, &group_wait, wait);
+    if ((unsigned long)file->private_data != (unsigned)atomic_read(&groups_gen))
+        return POLLIN | POLLRDNORM;
+    return 0;
+}
+
+/*
+ * Writing a group name waits for it (echo grp_usb > /proc/async_minit_groups), its error is returned
+ */
+static ssize_t groups_write(struct file *file, const char __user *buf,size_t nbytes, loff_t *ppos)
+{
+    char name[64];
+    size_t len;
+    unsigned id;
+    int ret;
+    if (nbytes == 0)
+        return 0;
+    len = nbytes < sizeof(name) ? nbytes : sizeof(name) - 1;
+    if (copy_from_user(name, buf, len))
+        return -EFAULT;
+    name[len] = 0;
+    if (name[len - 1] == '\n')
+        name[len - 1] = 0;
+    for (id = 0; id < module_last && strcmp(getName((modules_e)id), name) != 0; ++id)
+        ;
+    if (strncmp(name, "grp_", 4) != 0 || id == module_last)
+        return -EINVAL;
+    ret = async_minit_wait_group((modules_e)id);
+    return ret < 0 ? ret : nbytes;
+}
+
+static const struct file_operations groups_fops = {
+   .read = groups_read,
+   .write = groups_write,
+   .poll = groups_poll,
+};
+
+/**
+ * Module entry point
+ */
+//static int async_init(void)
+//{
+//  struct task_struct *thr;
+//
+//  current_type = asynchronized;
+//  atomic_inc(&free_init_ref);
+//  thr = kthread_create(do_asynchronized, (void*) (0), "do_type");
+//  kthread_bind(thr, num_online_cpus() - 1);
+//  wake_up_process(thr);
+//  return 0;
+//}
+
+/**
+ * Register proc entry to allow deferred initialization
+ */
+static int async_init(void)
+{
+  struct task_struct *thr;
+  unsigned cpu;
+  unsigned last = 0;
 
-    //current_type = asynchronized;
-    atomic_inc(&free_init_ref);
+    atomic_inc(&free_init_ref);     // dropped when generic part tasks are done
+    for_each_online_cpu(cpu)
+        last = cpu;                 // left free by working threads
     thr = kthread_create(do_asynchronized, (void*) (0), "do_type");
-    kthread_bind(thr, num_online_cpus() - 1);
+    kthread_bind(thr, last);
     wake_up_process(thr);
 
     proc_create("deferred_initcalls", 0, NULL, &deferred_initcalls_fops);
+    proc_create("async_initcall_times", 0444, NULL, &initcall_times_fops);
+    proc_create("async_initcall_times.bin", 0444, NULL, &initcall_times_bin_fops);
+    proc_create("async_minit_groups", 0644, NULL, &groups_fops);
     return 0;
 }
 
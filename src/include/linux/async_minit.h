@@ -20,7 +20,6 @@
     fnc(grp_none) \
     fnc(grp_hid) \
     fnc(grp_dma) \
-    fnc(grp_char) \
     fnc(grp_usb) \
     fnc(grp_ssb)  /*broadcomm bus */ \
     fnc(grp_snd_hda) \
@@ -702,19 +701,39 @@ typedef enum   {
  * Task type or execution priority
  * async - needs to be execute in an asynchronized way
  * deferred - it can be execute at user initialization time
+ * critical - asynchronized, root file system is not mounted until it is done
  */
  enum task_type_t { //
     asynchronized, //
     deferred, //
+    critical, //
     disable,
     end,         // no task, end of processing
     waiting, //
     } ;
 
-#define GET_10(fnc,n0,n1,n2,n3,n4,n5,n6,n7,n8,n9,n10,...) fnc##n10
-#define COUNT_ARG(fnc,...) GET_10(fnc,__VA_ARGS__,10,9,8,7,6,5,4,3,2,1)
+#define GET_16(fnc,n0,n1,n2,n3,n4,n5,n6,n7,n8,n9,n10,n11,n12,n13,n14,n15,n16,...) fnc##n16
+#define COUNT_ARG(fnc,...) GET_16(fnc,__VA_ARGS__,16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1)
 #define CALL_FNC(fnc,...) COUNT_ARG(fnc,__VA_ARGS__)(__VA_ARGS__)
 
+/*
+ * Init memory released in parts, every one as soon as nothing is going to use it.
+ * Generated driver init functions of deferred modules are linked in the deferred part (ASYNC_DEFERRED_TEXT),
+ * __async_minit_init* are async module initialization tables and the code filling them, released last,
+ * everything else is released when kernel_init and asynchronized initcalls are done
+ */
+#if defined(CONFIG_ASYNCHRO_MODULE_INIT) && !defined(MODULE)
+#define __async_minit_init          __section(.init.async_minit.text) __cold notrace
+#define __async_minit_initdata      __section(.init.async_minit.data)
+#define __async_minit_initconst     __section(.init.async_minit.rodata)
+#define __driver_init(fnc)          __attribute__((__section__(".init.text.async." #fnc))) __cold notrace
+#else
+#define __async_minit_init          __init
+#define __async_minit_initdata      __initdata
+#define __async_minit_initconst     __initconst
+#define __driver_init(fnc)          __init
+#endif
+
 struct init_fn_t_4
 {
   modules_e  id;
@@ -723,11 +742,11 @@ struct init_fn_t_4
 
 #define ASYNC_MODULE_INIT(fnc) \
     static const struct init_fn_t_4 init_fn_##fnc __used \
-     __attribute__((__section__(".async_initcall.init"))) = {fnc ## _id,fnc};
+     __attribute__((__section__(".async_initcall.init." #fnc))) = {fnc ## _id,fnc};
 
-// Usefull for ACPI and USB maybe PCI
+// Usefull for ACPI and USB maybe PCI, init text goes to .init.text.async.<fnc> to be linked by type
 #define ASYNC_MODULE_DRIVER(__driver, __register, __unregister) \
-static int __init __driver##_init(void) \
+static int __driver_init(__driver##_init) __driver##_init(void) \
 { \
   return __register(&(__driver)); \
 } \
@@ -762,6 +781,38 @@ module_exit(__driver##_exit);
 
 #endif
 
+/*
+ * Initialization on demand, a device node without driver or a class name runs its modules now
+ */
+int async_minit_demand_dev(char type, unsigned major);
+int async_minit_demand_name(const char* name);
+
+/*
+ * Wait for critical tasks, storage and file system needed to mount root
+ */
+void async_minit_wait_critical(void);
+
+/*
+ * Wait for a group of modules (grp_usb_id ..), 0 when all its members are done
+ */
+int async_minit_wait_group(modules_e id);
+
+/*
+ * kernel_init is done with generic init memory, it is released when asynchronized initcalls are done too
+ */
+void async_minit_release_init(void);
+
+/*
+ * Release a part of init memory, the default one poisons it like free_initmem_default,
+ * architectures that protect init memory (x86 free_init_pages) override it
+ */
+void free_initmem_part(void* begin, void* end, const char* what);
+
+/*
+ * kernel_init hands over to userspace, deferred initcalls may go on in background
+ */
+void async_minit_background(void);
+
 /*
  * Default initialization
  */
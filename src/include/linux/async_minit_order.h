@@ -0,0 +1,950 @@
+/*
+ * Generated by utils/async-order from the dependency table in drivers/async.c, do not edit.
+ * Async initcalls are linked in dependency order, parents first and ready ones by priority
+ */
+
+#ifndef ASYNC_MINIT_ORDER_H_
+#define ASYNC_MINIT_ORDER_H_
+
+#define ASYNC_INITCALLS_ORDER \
+	*(.async_initcall.init.ahci_pci_driver_init) \
+	*(.async_initcall.init.init_hugetlbfs_fs) \
+	*(.async_initcall.init.init_mbcache) \
+	*(.async_initcall.init.init_sd) \
+	*(.async_initcall.init.ext4_init_fs) \
+	*(.async_initcall.init.crc_t10dif_mod_init) \
+	*(.async_initcall.init.libcrc32c_mod_init) \
+	*(.async_initcall.init.ehci_hcd_init) \
+	*(.async_initcall.init.ehci_pci_init) \
+	*(.async_initcall.init.forcedeth_pci_driver_init) \
+	*(.async_initcall.init.ssb_modinit) \
+	*(.async_initcall.init.ehci_platform_init) \
+	*(.async_initcall.init.ohci_hcd_mod_init) \
+	*(.async_initcall.init.ohci_pci_init) \
+	*(.async_initcall.init.b43_init) \
+	*(.async_initcall.init.i8042_init) \
+	*(.async_initcall.init.prng_mod_init) \
+	*(.async_initcall.init.acpi_video_init) \
+	*(.async_initcall.init.ioat_init_module) \
+	*(.async_initcall.init.agp_init) \
+	*(.async_initcall.init.drm_core_init) \
+	*(.async_initcall.init.nvidia_frontend_init_module) \
+	*(.async_initcall.init.loop_init) \
+	*(.async_initcall.init.sha512_generic_mod_init) \
+	*(.async_initcall.init.acpi_thermal_init) \
+	*(.async_initcall.init.cmos_init) \
+	*(.async_initcall.init.acpi_button_driver_init) \
+	*(.async_initcall.init.wp512_mod_init) \
+	*(.async_initcall.init.blowfish_mod_init) \
+	*(.async_initcall.init.pcie_portdrv_init) \
+	*(.async_initcall.init.acpi_ac_init) \
+	*(.async_initcall.init.azx_driver_init) \
+	*(.async_initcall.init.brd_init) \
+	*(.async_initcall.init.zlib_mod_init) \
+	*(.async_initcall.init.tgr192_mod_init) \
+	*(.async_initcall.init.sha256_generic_mod_init) \
+	*(.async_initcall.init.arc4_init) \
+	*(.async_initcall.init.alsa_timer_init) \
+	*(.async_initcall.init.alsa_seq_device_init) \
+	*(.async_initcall.init.ohci_platform_init) \
+	*(.async_initcall.init.alsa_seq_init) \
+	*(.async_initcall.init.hid_init) \
+	*(.async_initcall.init.pci_hotplug_init) \
+	*(.async_initcall.init.fbmem_init) \
+	*(.async_initcall.init.alsa_hwdep_init) \
+	*(.async_initcall.init.alsa_mixer_oss_init) \
+	*(.async_initcall.init.alsa_pcm_init) \
+	*(.async_initcall.init.alsa_seq_midi_event_init) \
+	*(.async_initcall.init.snd_hda_controller) \
+	*(.async_initcall.init.init_mtd) \
+	*(.async_initcall.init.uio_init) \
+	*(.async_initcall.init.usb_storage_driver_init) \
+	*(.async_initcall.init.usb_hid_init) \
+	*(.async_initcall.init.libphy) \
+	*(.async_initcall.init.lib80211_init) \
+	*(.async_initcall.init.hwrng_modinit) \
+	*(.async_initcall.init.af_alg_init) \
+	*(.async_initcall.init.crypto_authenc_module_init) \
+	*(.async_initcall.init.fuse_init) \
+	*(.async_initcall.init.journal_init) \
+	*(.async_initcall.init.init_fat_fs) \
+	*(.async_initcall.init.pcied_init) \
+	*(.async_initcall.init.pty_init) \
+	*(.async_initcall.init.ahci_driver_init) \
+	*(.async_initcall.init.generic_driver_init) \
+	*(.async_initcall.init.cmedia_driver_init) \
+	*(.async_initcall.init.realtek_driver_init) \
+	*(.async_initcall.init.analog_driver_init) \
+	*(.async_initcall.init.si3054_driver_init) \
+	*(.async_initcall.init.cirrus_driver_init) \
+	*(.async_initcall.init.sigmatel_driver_init) \
+	*(.async_initcall.init.ca0110_driver_init) \
+	*(.async_initcall.init.ca0132_driver_init) \
+	*(.async_initcall.init.conexant_driver_init) \
+	*(.async_initcall.init.via_driver_init) \
+	*(.async_initcall.init.hdmi_driver_init) \
+	*(.async_initcall.init.mda_console_init) \
+	*(.async_initcall.init.newport_console_init) \
+	*(.async_initcall.init.sticonsole_init) \
+	*(.async_initcall.init.agp_nvidia_init) \
+	*(.async_initcall.init.uvm_init) \
+	*(.async_initcall.init.pch_dma_driver_init) \
+	*(.async_initcall.init.ismt_driver_init) \
+	*(.async_initcall.init.lpc_sch_driver_init) \
+	*(.async_initcall.init.lpc_ich_driver_init) \
+	*(.async_initcall.init.serial8250_init) \
+	*(.async_initcall.init.nforce2_driver_init) \
+	*(.async_initcall.init.crypto_xcbc_module_init) \
+	*(.async_initcall.init.init_cifs) \
+	*(.async_initcall.init.acpi_pcc_driver) \
+	*(.async_initcall.init.acpi_hed_driver) \
+	*(.async_initcall.init.acpi_smb_hc_driver) \
+	*(.async_initcall.init.crb_acpi_driver) \
+	*(.async_initcall.init.acpi_smbus_cmi_driver) \
+	*(.async_initcall.init.atlas_acpi_driver) \
+	*(.async_initcall.init.smo8800_driver) \
+	*(.async_initcall.init.lis3lv02d_driver) \
+	*(.async_initcall.init.irst_driver) \
+	*(.async_initcall.init.smartconnect_driver) \
+	*(.async_initcall.init.pvpanic_driver) \
+	*(.async_initcall.init.acpi_topstar_driver) \
+	*(.async_initcall.init.toshiba_bt_rfkill_driver) \
+	*(.async_initcall.init.toshiba_haps_driver) \
+	*(.async_initcall.init.xo15_ebook_driver) \
+	*(.async_initcall.init.drm_fb_helper_modinit) \
+	*(.async_initcall.init.acpi_power_meter_init) \
+	*(.async_initcall.init.synusb_driver_init) \
+	*(.async_initcall.init.usblp_driver_init) \
+	*(.async_initcall.init.rfcomm_init) \
+	*(.async_initcall.init.snd_hrtimer_init) \
+	*(.async_initcall.init.alsa_pcm_oss_init) \
+	*(.async_initcall.init.alsa_seq_dummy_init) \
+	*(.async_initcall.init.patch_si3054_init) \
+	*(.async_initcall.init.patch_ca0132_init) \
+	*(.async_initcall.init.patch_hdmi_init) \
+	*(.async_initcall.init.alsa_seq_oss_init) \
+	*(.async_initcall.init.snd_hda_intel) \
+	*(.async_initcall.init.patch_sigmatel_init) \
+	*(.async_initcall.init.patch_cirrus_init) \
+	*(.async_initcall.init.patch_ca0110_init) \
+	*(.async_initcall.init.patch_via_init) \
+	*(.async_initcall.init.patch_realtek_init) \
+	*(.async_initcall.init.patch_conexant_init) \
+	*(.async_initcall.init.patch_cmedia_init) \
+	*(.async_initcall.init.patch_analog_init) \
+	*(.async_initcall.init.coretemp) \
+	*(.async_initcall.init.gpio_fan) \
+	*(.async_initcall.init.acpi_processor_driver_init) \
+	*(.async_initcall.init.ubi_init) \
+	*(.async_initcall.init.hilscher_pci_driver_init) \
+	*(.async_initcall.init.mxm_wmi_init) \
+	*(.async_initcall.init.speedstep_init) \
+	*(.async_initcall.init.mmc_blk_init) \
+	*(.async_initcall.init.uvcvideo) \
+	*(.async_initcall.init.gspca_main) \
+	*(.async_initcall.init.ir_kbd_driver) \
+	*(.async_initcall.init.i2c_mux_gpio_driver) \
+	*(.async_initcall.init.pca9541_driver) \
+	*(.async_initcall.init.pca954x_driver) \
+	*(.async_initcall.init.uhci_hcd_init) \
+	*(.async_initcall.init.usbmon) \
+	*(.async_initcall.init.led_driver_init) \
+	*(.async_initcall.init.uhid_init) \
+	*(.async_initcall.init.hid_generic_init) \
+	*(.async_initcall.init.hid_generic) \
+	*(.async_initcall.init.cherry_driver_init) \
+	*(.async_initcall.init.chicony_driver_init) \
+	*(.async_initcall.init.apple_driver_init) \
+	*(.async_initcall.init.a4_driver_init) \
+	*(.async_initcall.init.ez_driver_init) \
+	*(.async_initcall.init.cp_driver_init) \
+	*(.async_initcall.init.ks_driver_init) \
+	*(.async_initcall.init.ms_driver_init) \
+	*(.async_initcall.init.lg_driver_init) \
+	*(.async_initcall.init.mr_driver_init) \
+	*(.async_initcall.init.belkin_driver_init) \
+	*(.async_initcall.init.plantronics_driver_init) \
+	*(.async_initcall.init.keytouch_driver_init) \
+	*(.async_initcall.init.ene_ub6250_driver_init) \
+	*(.async_initcall.init.uas_driver_init) \
+	*(.async_initcall.init.realtek_cr_driver_init) \
+	*(.async_initcall.init.smsc) \
+	*(.async_initcall.init.lib80211_crypto_tkip_init) \
+	*(.async_initcall.init.lib80211_crypto_wep_init) \
+	*(.async_initcall.init.lib80211_crypto_ccmp_init) \
+	*(.async_initcall.init.libipw_init) \
+	*(.async_initcall.init.led_class) \
+	*(.async_initcall.init.ipw2100_init) \
+	*(.async_initcall.init.leds_pca955x) \
+	*(.async_initcall.init.b43) \
+	*(.async_initcall.init.b43legacy_init) \
+	*(.async_initcall.init.intel_rng_mod_init) \
+	*(.async_initcall.init.algif_hash_init) \
+	*(.async_initcall.init.algif_skcipher_init) \
+	*(.async_initcall.init.alg_hash) \
+	*(.async_initcall.init.lzo_mod_init) \
+	*(.async_initcall.init.crypto_authenc_esn_module_init) \
+	*(.async_initcall.init.cast5_mod_init) \
+	*(.async_initcall.init.cast6_mod_init) \
+	*(.async_initcall.init.prgn_mod_init) \
+	*(.async_initcall.init.crypto_cbc_module_init) \
+	*(.async_initcall.init.crc32_mod_init) \
+	*(.async_initcall.init.crc32c_mod_init) \
+	*(.async_initcall.init.twofish_mod_init) \
+	*(.async_initcall.init.crct10dif_mod_init) \
+	*(.async_initcall.init.crypto_null_mod_init) \
+	*(.async_initcall.init.crypto_ecb_module_init) \
+	*(.async_initcall.init.crypto_module_init) \
+	*(.async_initcall.init.crypto_user_init) \
+	*(.async_initcall.init.lz4_mod_init) \
+	*(.async_initcall.init.md4_mod_init) \
+	*(.async_initcall.init.md5_mod_init) \
+	*(.async_initcall.init.rmd128_mod_init) \
+	*(.async_initcall.init.rmd160_mod_init) \
+	*(.async_initcall.init.rmd256_mod_init) \
+	*(.async_initcall.init.rmd320_mod_init) \
+	*(.async_initcall.init.sha1_generic_mod_init) \
+	*(.async_initcall.init.elo_driver_init) \
+	*(.async_initcall.init.tcrypt_mod_init) \
+	*(.async_initcall.init.tea_mod_init) \
+	*(.async_initcall.init.init_iso9660_fs) \
+	*(.async_initcall.init.cuse_init) \
+	*(.async_initcall.init.init_ext3_fs) \
+	*(.async_initcall.init.init_vfat_fs) \
+	*(.async_initcall.init.init_msdos_fs) \
+	*(.async_initcall.init.init_ntfs_fs) \
+	*(.async_initcall.init.acpi_ipmi_init) \
+	*(.async_initcall.init.acpi_pad_init) \
+	*(.async_initcall.init.acpi_battery_init) \
+	*(.async_initcall.init.acpi_sbs_init) \
+	*(.async_initcall.init.cpufreq_gov_dbs_init) \
+	*(.async_initcall.init.cpufreq_gov_powersave_init) \
+	*(.async_initcall.init.cpufreq_stats_init) \
+	*(.async_initcall.init.cpufreq_gov_userspace_init) \
+	*(.async_initcall.init.hpet_init) \
+	*(.async_initcall.init.shpcd_init) \
+	*(.async_initcall.init.twofish_generic) \
+	*(.async_initcall.init.twofish_i586) \
+	*(.async_initcall.init.asymmetric_key_init) \
+	*(.async_initcall.init.pkcs7_key_init) \
+	*(.async_initcall.init.x509_key_init) \
+	*(.async_initcall.init.aes_init) \
+	*(.async_initcall.init.vmac_module_init) \
+	*(.async_initcall.init.mousedev_init) \
+	*(.async_initcall.init.atkbd_init) \
+	*(.async_initcall.init.uinput_init) \
+	*(.async_initcall.init.psmouse_init) \
+	*(.async_initcall.init.serport_init) \
+	*(.async_initcall.init.vb2_thread_init) \
+	*(.async_initcall.init.crypto_algapi_init) \
+	*(.async_initcall.init.chainiv_module_init) \
+	*(.async_initcall.init.pcie_pme_service_init) \
+	*(.async_initcall.init.seqiv_module_init) \
+	*(.async_initcall.init.eseqiv_module_init) \
+	*(.async_initcall.init.crypto_cmac_module_init) \
+	*(.async_initcall.init.crypto_pcbc_module_init) \
+	*(.async_initcall.init.crypto_ctr_module_init) \
+	*(.async_initcall.init.crypto_gcm_module_init) \
+	*(.async_initcall.init.hmac_module_init) \
+	*(.async_initcall.init.crypto_cts_module_init) \
+	*(.async_initcall.init.crypto_ccm_module_init) \
+	*(.async_initcall.init.des_generic_mod_init) \
+	*(.async_initcall.init.fcrypt_mod_init) \
+	*(.async_initcall.init.serpent_mod_init) \
+	*(.async_initcall.init.camellia_init) \
+	*(.async_initcall.init.khazad_mod_init) \
+	*(.async_initcall.init.seed_init) \
+	*(.async_initcall.init.anubis_mod_init) \
+	*(.async_initcall.init.salsa20_generic_mod_init) \
+	*(.async_initcall.init.krng_mod_init) \
+	*(.async_initcall.init.michael_mic_init) \
+	*(.async_initcall.init.ghash_mod_init) \
+	*(.async_initcall.init.async_pq_init) \
+	*(.async_initcall.init.deflate_mod_init) \
+	*(.async_initcall.init.tcp_congestion_default) \
+	*(.async_initcall.init.i2c_hid_driver_init) \
+	*(.async_initcall.init.smbalert_driver_init) \
+	*(.async_initcall.init.pca9541_driver_init) \
+	*(.async_initcall.init.pca954x_driver_init) \
+	*(.async_initcall.init.pca955x_driver_init) \
+	*(.async_initcall.init.ir_kbd_driver_init) \
+	*(.async_initcall.init.serial_pci_driver_init) \
+	*(.async_initcall.init.spi_gpio_driver_init) \
+	*(.async_initcall.init.init_per_zone_wmark_min) \
+	*(.async_initcall.init.init) \
+	*(.async_initcall.init.proc_execdomains_init) \
+	*(.async_initcall.init.kswapd_init) \
+	*(.async_initcall.init.proc_modules_init) \
+	*(.async_initcall.init.fcntl_init) \
+	*(.async_initcall.init.acpi_fan_driver_init) \
+	*(.async_initcall.init.cn_proc_init) \
+	*(.async_initcall.init.nvram_init) \
+	*(.async_initcall.init.mod_init) \
+	*(.async_initcall.init.coretemp_init) \
+	*(.async_initcall.init.gpio_fan_driver_init) \
+	*(.async_initcall.init.i2c_dev_init) \
+	*(.async_initcall.init.i2c_i801_init) \
+	*(.async_initcall.init.smbus_sch_driver_init) \
+	*(.async_initcall.init.i2c_mux_gpio_driver_init) \
+	*(.async_initcall.init.intel_idle_init) \
+	*(.async_initcall.init.simtec_i2c_driver_init) \
+	*(.async_initcall.init.evdev_init) \
+	*(.async_initcall.init.gspca_init) \
+	*(.async_initcall.init.uvc_init) \
+	*(.async_initcall.init.ptp_pch_init) \
+	*(.async_initcall.init.phy_module_init) \
+	*(.async_initcall.init.init_sg) \
+	*(.async_initcall.init.sbf_init) \
+	*(.async_initcall.init.setup_vmstat) \
+	*(.async_initcall.init.extfrag_debug_init) \
+	*(.async_initcall.init.proc_filesystems_init) \
+	*(.async_initcall.init.dio_init) \
+	*(.async_initcall.init.init_autofs4_fs) \
+	*(.async_initcall.init.configfs_init) \
+	*(.async_initcall.init.init_devpts_fs) \
+	*(.async_initcall.init.init_ext2_fs) \
+	*(.async_initcall.init.init_nls_cp437) \
+	*(.async_initcall.init.init_nls_cp850) \
+	*(.async_initcall.init.init_nls_cp852) \
+	*(.async_initcall.init.dnotify_init) \
+	*(.async_initcall.init.init_nls_ascii) \
+	*(.async_initcall.init.init_nls_iso8859_1) \
+	*(.async_initcall.init.init_nls_utf8) \
+	*(.async_initcall.init.inotify_user_setup) \
+	*(.async_initcall.init.proc_locks_init) \
+	*(.async_initcall.init.init_udf_fs) \
+	*(.async_initcall.init.proc_genhd_init) \
+	*(.async_initcall.init.noop_init) \
+	*(.async_initcall.init.deadline_init) \
+	*(.async_initcall.init.cfq_init) \
+	*(.async_initcall.init.init_dns_resolver) \
+	*(.async_initcall.init.sock_diag_init) \
+	*(.async_initcall.init.cubictcp_register) \
+	*(.async_initcall.init.packet_init) \
+	*(.async_initcall.init.slab_proc_init) \
+	*(.async_initcall.init.workingset_init) \
+	*(.async_initcall.init.hugetlb_init) \
+	*(.async_initcall.init.proc_vmalloc_init) \
+	*(.async_initcall.init.ikconfig_init) \
+	*(.async_initcall.init.percpu_counter_startup) \
+	*(.async_initcall.init.pcips2_driver_init) \
+	*(.async_initcall.init.sermouse_drv_init) \
+	*(.async_initcall.init.serio_raw_drv_init) \
+	*(.async_initcall.init.oprofile_init) \
+	*(.async_initcall.init.add_pcspkr) \
+	*(.async_initcall.init.acpi_smb_hc_driver_init) \
+	*(.async_initcall.init.nforce2_init) \
+	*(.async_initcall.init.snd_compress_init) \
+	*(.async_initcall.init.pcspkr_platform_driver_init) \
+	*(.async_initcall.init.deinterlace_pdrv_init) \
+
+#define ASYNC_DEFERRED_TEXT \
+	*(.init.text.async.ehci_hcd_init) \
+	*(.init.text.async.ehci_pci_init) \
+	*(.init.text.async.forcedeth_pci_driver_init) \
+	*(.init.text.async.ssb_modinit) \
+	*(.init.text.async.ehci_platform_init) \
+	*(.init.text.async.ohci_hcd_mod_init) \
+	*(.init.text.async.ohci_pci_init) \
+	*(.init.text.async.b43_init) \
+	*(.init.text.async.i8042_init) \
+	*(.init.text.async.prng_mod_init) \
+	*(.init.text.async.loop_init) \
+	*(.init.text.async.sha512_generic_mod_init) \
+	*(.init.text.async.acpi_thermal_init) \
+	*(.init.text.async.cmos_init) \
+	*(.init.text.async.acpi_button_driver_init) \
+	*(.init.text.async.wp512_mod_init) \
+	*(.init.text.async.blowfish_mod_init) \
+	*(.init.text.async.pcie_portdrv_init) \
+	*(.init.text.async.azx_driver_init) \
+	*(.init.text.async.brd_init) \
+	*(.init.text.async.zlib_mod_init) \
+	*(.init.text.async.tgr192_mod_init) \
+	*(.init.text.async.sha256_generic_mod_init) \
+	*(.init.text.async.arc4_init) \
+	*(.init.text.async.alsa_timer_init) \
+	*(.init.text.async.alsa_seq_device_init) \
+	*(.init.text.async.ohci_platform_init) \
+	*(.init.text.async.alsa_seq_init) \
+	*(.init.text.async.hid_init) \
+	*(.init.text.async.pci_hotplug_init) \
+	*(.init.text.async.alsa_hwdep_init) \
+	*(.init.text.async.alsa_mixer_oss_init) \
+	*(.init.text.async.alsa_pcm_init) \
+	*(.init.text.async.alsa_seq_midi_event_init) \
+	*(.init.text.async.snd_hda_controller) \
+	*(.init.text.async.init_mtd) \
+	*(.init.text.async.uio_init) \
+	*(.init.text.async.usb_storage_driver_init) \
+	*(.init.text.async.usb_hid_init) \
+	*(.init.text.async.libphy) \
+	*(.init.text.async.lib80211_init) \
+	*(.init.text.async.hwrng_modinit) \
+	*(.init.text.async.af_alg_init) \
+	*(.init.text.async.crypto_authenc_module_init) \
+	*(.init.text.async.fuse_init) \
+	*(.init.text.async.journal_init) \
+	*(.init.text.async.init_fat_fs) \
+	*(.init.text.async.pcied_init) \
+	*(.init.text.async.generic_driver_init) \
+	*(.init.text.async.cmedia_driver_init) \
+	*(.init.text.async.realtek_driver_init) \
+	*(.init.text.async.analog_driver_init) \
+	*(.init.text.async.si3054_driver_init) \
+	*(.init.text.async.cirrus_driver_init) \
+	*(.init.text.async.sigmatel_driver_init) \
+	*(.init.text.async.ca0110_driver_init) \
+	*(.init.text.async.ca0132_driver_init) \
+	*(.init.text.async.conexant_driver_init) \
+	*(.init.text.async.via_driver_init) \
+	*(.init.text.async.hdmi_driver_init) \
+	*(.init.text.async.ismt_driver_init) \
+	*(.init.text.async.lpc_sch_driver_init) \
+	*(.init.text.async.lpc_ich_driver_init) \
+	*(.init.text.async.serial8250_init) \
+	*(.init.text.async.nforce2_driver_init) \
+	*(.init.text.async.crypto_xcbc_module_init) \
+	*(.init.text.async.init_cifs) \
+	*(.init.text.async.acpi_pcc_driver) \
+	*(.init.text.async.acpi_hed_driver) \
+	*(.init.text.async.acpi_smb_hc_driver) \
+	*(.init.text.async.crb_acpi_driver) \
+	*(.init.text.async.acpi_smbus_cmi_driver) \
+	*(.init.text.async.atlas_acpi_driver) \
+	*(.init.text.async.smo8800_driver) \
+	*(.init.text.async.lis3lv02d_driver) \
+	*(.init.text.async.irst_driver) \
+	*(.init.text.async.smartconnect_driver) \
+	*(.init.text.async.pvpanic_driver) \
+	*(.init.text.async.acpi_topstar_driver) \
+	*(.init.text.async.toshiba_bt_rfkill_driver) \
+	*(.init.text.async.toshiba_haps_driver) \
+	*(.init.text.async.xo15_ebook_driver) \
+	*(.init.text.async.drm_fb_helper_modinit) \
+	*(.init.text.async.acpi_power_meter_init) \
+	*(.init.text.async.synusb_driver_init) \
+	*(.init.text.async.usblp_driver_init) \
+	*(.init.text.async.rfcomm_init) \
+	*(.init.text.async.snd_hrtimer_init) \
+	*(.init.text.async.alsa_pcm_oss_init) \
+	*(.init.text.async.alsa_seq_dummy_init) \
+	*(.init.text.async.patch_si3054_init) \
+	*(.init.text.async.patch_ca0132_init) \
+	*(.init.text.async.patch_hdmi_init) \
+	*(.init.text.async.alsa_seq_oss_init) \
+	*(.init.text.async.snd_hda_intel) \
+	*(.init.text.async.patch_sigmatel_init) \
+	*(.init.text.async.patch_cirrus_init) \
+	*(.init.text.async.patch_ca0110_init) \
+	*(.init.text.async.patch_via_init) \
+	*(.init.text.async.patch_realtek_init) \
+	*(.init.text.async.patch_conexant_init) \
+	*(.init.text.async.patch_cmedia_init) \
+	*(.init.text.async.patch_analog_init) \
+	*(.init.text.async.coretemp) \
+	*(.init.text.async.gpio_fan) \
+	*(.init.text.async.acpi_processor_driver_init) \
+	*(.init.text.async.ubi_init) \
+	*(.init.text.async.hilscher_pci_driver_init) \
+	*(.init.text.async.mxm_wmi_init) \
+	*(.init.text.async.speedstep_init) \
+	*(.init.text.async.mmc_blk_init) \
+	*(.init.text.async.uvcvideo) \
+	*(.init.text.async.gspca_main) \
+	*(.init.text.async.ir_kbd_driver) \
+	*(.init.text.async.i2c_mux_gpio_driver) \
+	*(.init.text.async.pca9541_driver) \
+	*(.init.text.async.pca954x_driver) \
+	*(.init.text.async.uhci_hcd_init) \
+	*(.init.text.async.usbmon) \
+	*(.init.text.async.led_driver_init) \
+	*(.init.text.async.uhid_init) \
+	*(.init.text.async.hid_generic_init) \
+	*(.init.text.async.hid_generic) \
+	*(.init.text.async.cherry_driver_init) \
+	*(.init.text.async.chicony_driver_init) \
+	*(.init.text.async.apple_driver_init) \
+	*(.init.text.async.a4_driver_init) \
+	*(.init.text.async.ez_driver_init) \
+	*(.init.text.async.cp_driver_init) \
+	*(.init.text.async.ks_driver_init) \
+	*(.init.text.async.ms_driver_init) \
+	*(.init.text.async.lg_driver_init) \
+	*(.init.text.async.mr_driver_init) \
+	*(.init.text.async.belkin_driver_init) \
+	*(.init.text.async.plantronics_driver_init) \
+	*(.init.text.async.keytouch_driver_init) \
+	*(.init.text.async.ene_ub6250_driver_init) \
+	*(.init.text.async.uas_driver_init) \
+	*(.init.text.async.realtek_cr_driver_init) \
+	*(.init.text.async.smsc) \
+	*(.init.text.async.lib80211_crypto_tkip_init) \
+	*(.init.text.async.lib80211_crypto_wep_init) \
+	*(.init.text.async.lib80211_crypto_ccmp_init) \
+	*(.init.text.async.libipw_init) \
+	*(.init.text.async.led_class) \
+	*(.init.text.async.ipw2100_init) \
+	*(.init.text.async.leds_pca955x) \
+	*(.init.text.async.b43) \
+	*(.init.text.async.b43legacy_init) \
+	*(.init.text.async.intel_rng_mod_init) \
+	*(.init.text.async.algif_hash_init) \
+	*(.init.text.async.algif_skcipher_init) \
+	*(.init.text.async.alg_hash) \
+	*(.init.text.async.lzo_mod_init) \
+	*(.init.text.async.crypto_authenc_esn_module_init) \
+	*(.init.text.async.cast5_mod_init) \
+	*(.init.text.async.cast6_mod_init) \
+	*(.init.text.async.prgn_mod_init) \
+	*(.init.text.async.crypto_cbc_module_init) \
+	*(.init.text.async.crc32_mod_init) \
+	*(.init.text.async.crc32c_mod_init) \
+	*(.init.text.async.twofish_mod_init) \
+	*(.init.text.async.crct10dif_mod_init) \
+	*(.init.text.async.crypto_null_mod_init) \
+	*(.init.text.async.crypto_ecb_module_init) \
+	*(.init.text.async.crypto_module_init) \
+	*(.init.text.async.crypto_user_init) \
+	*(.init.text.async.lz4_mod_init) \
+	*(.init.text.async.md4_mod_init) \
+	*(.init.text.async.md5_mod_init) \
+	*(.init.text.async.rmd128_mod_init) \
+	*(.init.text.async.rmd160_mod_init) \
+	*(.init.text.async.rmd256_mod_init) \
+	*(.init.text.async.rmd320_mod_init) \
+	*(.init.text.async.sha1_generic_mod_init) \
+	*(.init.text.async.elo_driver_init) \
+	*(.init.text.async.tcrypt_mod_init) \
+	*(.init.text.async.tea_mod_init) \
+	*(.init.text.async.init_iso9660_fs) \
+	*(.init.text.async.cuse_init) \
+	*(.init.text.async.init_ext3_fs) \
+	*(.init.text.async.init_vfat_fs) \
+	*(.init.text.async.init_msdos_fs) \
+	*(.init.text.async.init_ntfs_fs) \
+	*(.init.text.async.acpi_ipmi_init) \
+	*(.init.text.async.acpi_pad_init) \
+	*(.init.text.async.acpi_battery_init) \
+	*(.init.text.async.acpi_sbs_init) \
+	*(.init.text.async.cpufreq_gov_dbs_init) \
+	*(.init.text.async.cpufreq_gov_powersave_init) \
+	*(.init.text.async.cpufreq_stats_init) \
+	*(.init.text.async.cpufreq_gov_userspace_init) \
+	*(.init.text.async.hpet_init) \
+	*(.init.text.async.shpcd_init) \
+	*(.init.text.async.twofish_generic) \
+	*(.init.text.async.twofish_i586) \
+	*(.init.text.async.asymmetric_key_init) \
+	*(.init.text.async.pkcs7_key_init) \
+	*(.init.text.async.x509_key_init) \
+	*(.init.text.async.aes_init) \
+	*(.init.text.async.vmac_module_init) \
+	*(.init.text.async.mousedev_init) \
+	*(.init.text.async.atkbd_init) \
+	*(.init.text.async.uinput_init) \
+	*(.init.text.async.psmouse_init) \
+	*(.init.text.async.serport_init) \
+	*(.init.text.async.vb2_thread_init) \
+	*(.init.text.async.crypto_algapi_init) \
+	*(.init.text.async.chainiv_module_init) \
+	*(.init.text.async.pcie_pme_service_init) \
+	*(.init.text.async.seqiv_module_init) \
+	*(.init.text.async.eseqiv_module_init) \
+	*(.init.text.async.crypto_cmac_module_init) \
+	*(.init.text.async.crypto_pcbc_module_init) \
+	*(.init.text.async.crypto_ctr_module_init) \
+	*(.init.text.async.crypto_gcm_module_init) \
+	*(.init.text.async.hmac_module_init) \
+	*(.init.text.async.crypto_cts_module_init) \
+	*(.init.text.async.crypto_ccm_module_init) \
+	*(.init.text.async.des_generic_mod_init) \
+	*(.init.text.async.fcrypt_mod_init) \
+	*(.init.text.async.serpent_mod_init) \
+	*(.init.text.async.camellia_init) \
+	*(.init.text.async.khazad_mod_init) \
+	*(.init.text.async.seed_init) \
+	*(.init.text.async.anubis_mod_init) \
+	*(.init.text.async.salsa20_generic_mod_init) \
+	*(.init.text.async.krng_mod_init) \
+	*(.init.text.async.michael_mic_init) \
+	*(.init.text.async.ghash_mod_init) \
+	*(.init.text.async.async_pq_init) \
+	*(.init.text.async.deflate_mod_init) \
+	*(.init.text.async.tcp_congestion_default) \
+	*(.init.text.async.i2c_hid_driver_init) \
+	*(.init.text.async.smbalert_driver_init) \
+	*(.init.text.async.pca9541_driver_init) \
+	*(.init.text.async.pca954x_driver_init) \
+	*(.init.text.async.pca955x_driver_init) \
+	*(.init.text.async.ir_kbd_driver_init) \
+	*(.init.text.async.serial_pci_driver_init) \
+	*(.init.text.async.spi_gpio_driver_init) \
+	*(.init.text.async.acpi_fan_driver_init) \
+	*(.init.text.async.mod_init) \
+	*(.init.text.async.gpio_fan_driver_init) \
+	*(.init.text.async.smbus_sch_driver_init) \
+	*(.init.text.async.simtec_i2c_driver_init) \
+	*(.init.text.async.gspca_init) \
+	*(.init.text.async.uvc_init) \
+	*(.init.text.async.init_autofs4_fs) \
+	*(.init.text.async.init_ext2_fs) \
+	*(.init.text.async.init_udf_fs) \
+	*(.init.text.async.noop_init) \
+	*(.init.text.async.cfq_init) \
+	*(.init.text.async.init_dns_resolver) \
+	*(.init.text.async.packet_init) \
+	*(.init.text.async.pcips2_driver_init) \
+	*(.init.text.async.sermouse_drv_init) \
+	*(.init.text.async.serio_raw_drv_init) \
+	*(.init.text.async.oprofile_init) \
+	*(.init.text.async.add_pcspkr) \
+	*(.init.text.async.acpi_smb_hc_driver_init) \
+	*(.init.text.async.nforce2_init) \
+	*(.init.text.async.snd_compress_init) \
+	*(.init.text.async.pcspkr_platform_driver_init) \
+	*(.init.text.async.deinterlace_pdrv_init) \
+
+#define ahci_pci_driver_init_rank 0
+#define init_hugetlbfs_fs_rank 1
+#define init_mbcache_rank 2
+#define init_sd_rank 3
+#define ext4_init_fs_rank 4
+#define crc_t10dif_mod_init_rank 5
+#define libcrc32c_mod_init_rank 6
+#define ehci_hcd_init_rank 7
+#define ehci_pci_init_rank 8
+#define forcedeth_pci_driver_init_rank 9
+#define ssb_modinit_rank 10
+#define ehci_platform_init_rank 11
+#define ohci_hcd_mod_init_rank 12
+#define ohci_pci_init_rank 13
+#define grp_ssb_rank 14
+#define b43_init_rank 15
+#define i8042_init_rank 16
+#define prng_mod_init_rank 17
+#define acpi_video_init_rank 18
+#define ioat_init_module_rank 19
+#define agp_init_rank 20
+#define drm_core_init_rank 21
+#define nvidia_frontend_init_module_rank 22
+#define loop_init_rank 23
+#define sha512_generic_mod_init_rank 24
+#define acpi_thermal_init_rank 25
+#define cmos_init_rank 26
+#define acpi_button_driver_init_rank 27
+#define wp512_mod_init_rank 28
+#define blowfish_mod_init_rank 29
+#define pcie_portdrv_init_rank 30
+#define acpi_ac_init_rank 31
+#define azx_driver_init_rank 32
+#define brd_init_rank 33
+#define zlib_mod_init_rank 34
+#define tgr192_mod_init_rank 35
+#define sha256_generic_mod_init_rank 36
+#define arc4_init_rank 37
+#define alsa_timer_init_rank 38
+#define alsa_seq_device_init_rank 39
+#define ohci_platform_init_rank 40
+#define alsa_seq_init_rank 41
+#define hid_init_rank 42
+#define pci_hotplug_init_rank 43
+#define fbmem_init_rank 44
+#define alsa_hwdep_init_rank 45
+#define alsa_mixer_oss_init_rank 46
+#define alsa_pcm_init_rank 47
+#define alsa_seq_midi_event_init_rank 48
+#define snd_hda_controller_rank 49
+#define init_mtd_rank 50
+#define uio_init_rank 51
+#define usb_storage_driver_init_rank 52
+#define usb_hid_init_rank 53
+#define libphy_rank 54
+#define lib80211_init_rank 55
+#define hwrng_modinit_rank 56
+#define af_alg_init_rank 57
+#define crypto_authenc_module_init_rank 58
+#define fuse_init_rank 59
+#define journal_init_rank 60
+#define init_fat_fs_rank 61
+#define pcied_init_rank 62
+#define pty_init_rank 63
+#define ahci_driver_init_rank 64
+#define generic_driver_init_rank 65
+#define cmedia_driver_init_rank 66
+#define realtek_driver_init_rank 67
+#define analog_driver_init_rank 68
+#define si3054_driver_init_rank 69
+#define cirrus_driver_init_rank 70
+#define sigmatel_driver_init_rank 71
+#define ca0110_driver_init_rank 72
+#define ca0132_driver_init_rank 73
+#define conexant_driver_init_rank 74
+#define via_driver_init_rank 75
+#define hdmi_driver_init_rank 76
+#define mda_console_init_rank 77
+#define newport_console_init_rank 78
+#define sticonsole_init_rank 79
+#define agp_nvidia_init_rank 80
+#define uvm_init_rank 81
+#define pch_dma_driver_init_rank 82
+#define ismt_driver_init_rank 83
+#define lpc_sch_driver_init_rank 84
+#define lpc_ich_driver_init_rank 85
+#define serial8250_init_rank 86
+#define nforce2_driver_init_rank 87
+#define crypto_xcbc_module_init_rank 88
+#define init_cifs_rank 89
+#define acpi_pcc_driver_rank 90
+#define acpi_hed_driver_rank 91
+#define acpi_smb_hc_driver_rank 92
+#define crb_acpi_driver_rank 93
+#define acpi_smbus_cmi_driver_rank 94
+#define atlas_acpi_driver_rank 95
+#define smo8800_driver_rank 96
+#define lis3lv02d_driver_rank 97
+#define irst_driver_rank 98
+#define smartconnect_driver_rank 99
+#define pvpanic_driver_rank 100
+#define acpi_topstar_driver_rank 101
+#define toshiba_bt_rfkill_driver_rank 102
+#define toshiba_haps_driver_rank 103
+#define xo15_ebook_driver_rank 104
+#define drm_fb_helper_modinit_rank 105
+#define acpi_power_meter_init_rank 106
+#define synusb_driver_init_rank 107
+#define usblp_driver_init_rank 108
+#define rfcomm_init_rank 109
+#define snd_hrtimer_init_rank 110
+#define alsa_pcm_oss_init_rank 111
+#define alsa_seq_dummy_init_rank 112
+#define patch_si3054_init_rank 113
+#define patch_ca0132_init_rank 114
+#define patch_hdmi_init_rank 115
+#define alsa_seq_oss_init_rank 116
+#define snd_hda_intel_rank 117
+#define patch_sigmatel_init_rank 118
+#define patch_cirrus_init_rank 119
+#define patch_ca0110_init_rank 120
+#define patch_via_init_rank 121
+#define patch_realtek_init_rank 122
+#define patch_conexant_init_rank 123
+#define patch_cmedia_init_rank 124
+#define patch_analog_init_rank 125
+#define coretemp_rank 126
+#define gpio_fan_rank 127
+#define acpi_processor_driver_init_rank 128
+#define ubi_init_rank 129
+#define hilscher_pci_driver_init_rank 130
+#define mxm_wmi_init_rank 131
+#define speedstep_init_rank 132
+#define mmc_blk_init_rank 133
+#define uvcvideo_rank 134
+#define gspca_main_rank 135
+#define ir_kbd_driver_rank 136
+#define i2c_mux_gpio_driver_rank 137
+#define pca9541_driver_rank 138
+#define pca954x_driver_rank 139
+#define uhci_hcd_init_rank 140
+#define usbmon_rank 141
+#define led_driver_init_rank 142
+#define uhid_init_rank 143
+#define hid_generic_init_rank 144
+#define hid_generic_rank 145
+#define cherry_driver_init_rank 146
+#define chicony_driver_init_rank 147
+#define apple_driver_init_rank 148
+#define a4_driver_init_rank 149
+#define ez_driver_init_rank 150
+#define cp_driver_init_rank 151
+#define ks_driver_init_rank 152
+#define ms_driver_init_rank 153
+#define lg_driver_init_rank 154
+#define mr_driver_init_rank 155
+#define belkin_driver_init_rank 156
+#define plantronics_driver_init_rank 157
+#define keytouch_driver_init_rank 158
+#define ene_ub6250_driver_init_rank 159
+#define uas_driver_init_rank 160
+#define realtek_cr_driver_init_rank 161
+#define smsc_rank 162
+#define lib80211_crypto_tkip_init_rank 163
+#define lib80211_crypto_wep_init_rank 164
+#define lib80211_crypto_ccmp_init_rank 165
+#define libipw_init_rank 166
+#define led_class_rank 167
+#define ipw2100_init_rank 168
+#define leds_pca955x_rank 169
+#define b43_rank 170
+#define b43legacy_init_rank 171
+#define intel_rng_mod_init_rank 172
+#define algif_hash_init_rank 173
+#define algif_skcipher_init_rank 174
+#define alg_hash_rank 175
+#define lzo_mod_init_rank 176
+#define crypto_authenc_esn_module_init_rank 177
+#define cast5_mod_init_rank 178
+#define cast6_mod_init_rank 179
+#define prgn_mod_init_rank 180
+#define crypto_cbc_module_init_rank 181
+#define crc32_mod_init_rank 182
+#define crc32c_mod_init_rank 183
+#define twofish_mod_init_rank 184
+#define crct10dif_mod_init_rank 185
+#define crypto_null_mod_init_rank 186
+#define crypto_ecb_module_init_rank 187
+#define crypto_module_init_rank 188
+#define crypto_user_init_rank 189
+#define lz4_mod_init_rank 190
+#define md4_mod_init_rank 191
+#define md5_mod_init_rank 192
+#define rmd128_mod_init_rank 193
+#define rmd160_mod_init_rank 194
+#define rmd256_mod_init_rank 195
+#define rmd320_mod_init_rank 196
+#define sha1_generic_mod_init_rank 197
+#define elo_driver_init_rank 198
+#define tcrypt_mod_init_rank 199
+#define tea_mod_init_rank 200
+#define init_iso9660_fs_rank 201
+#define cuse_init_rank 202
+#define init_ext3_fs_rank 203
+#define init_vfat_fs_rank 204
+#define init_msdos_fs_rank 205
+#define init_ntfs_fs_rank 206
+#define acpi_ipmi_init_rank 207
+#define acpi_pad_init_rank 208
+#define acpi_battery_init_rank 209
+#define acpi_sbs_init_rank 210
+#define cpufreq_gov_dbs_init_rank 211
+#define cpufreq_gov_powersave_init_rank 212
+#define cpufreq_stats_init_rank 213
+#define cpufreq_gov_userspace_init_rank 214
+#define hpet_init_rank 215
+#define shpcd_init_rank 216
+#define twofish_generic_rank 217
+#define twofish_i586_rank 218
+#define asymmetric_key_init_rank 219
+#define pkcs7_key_init_rank 220
+#define x509_key_init_rank 221
+#define aes_init_rank 222
+#define vmac_module_init_rank 223
+#define mousedev_init_rank 224
+#define atkbd_init_rank 225
+#define uinput_init_rank 226
+#define psmouse_init_rank 227
+#define serport_init_rank 228
+#define vb2_thread_init_rank 229
+#define crypto_algapi_init_rank 230
+#define chainiv_module_init_rank 231
+#define pcie_pme_service_init_rank 232
+#define seqiv_module_init_rank 233
+#define eseqiv_module_init_rank 234
+#define crypto_cmac_module_init_rank 235
+#define crypto_pcbc_module_init_rank 236
+#define crypto_ctr_module_init_rank 237
+#define crypto_gcm_module_init_rank 238
+#define hmac_module_init_rank 239
+#define crypto_cts_module_init_rank 240
+#define crypto_ccm_module_init_rank 241
+#define des_generic_mod_init_rank 242
+#define fcrypt_mod_init_rank 243
+#define serpent_mod_init_rank 244
+#define camellia_init_rank 245
+#define khazad_mod_init_rank 246
+#define seed_init_rank 247
+#define anubis_mod_init_rank 248
+#define salsa20_generic_mod_init_rank 249
+#define krng_mod_init_rank 250
+#define michael_mic_init_rank 251
+#define ghash_mod_init_rank 252
+#define async_pq_init_rank 253
+#define deflate_mod_init_rank 254
+#define tcp_congestion_default_rank 255
+#define i2c_hid_driver_init_rank 256
+#define smbalert_driver_init_rank 257
+#define pca9541_driver_init_rank 258
+#define pca954x_driver_init_rank 259
+#define pca955x_driver_init_rank 260
+#define ir_kbd_driver_init_rank 261
+#define serial_pci_driver_init_rank 262
+#define spi_gpio_driver_init_rank 263
+#define init_per_zone_wmark_min_rank 264
+#define init_rank 265
+#define proc_execdomains_init_rank 266
+#define kswapd_init_rank 267
+#define proc_modules_init_rank 268
+#define fcntl_init_rank 269
+#define acpi_fan_driver_init_rank 270
+#define cn_proc_init_rank 271
+#define nvram_init_rank 272
+#define mod_init_rank 273
+#define coretemp_init_rank 274
+#define gpio_fan_driver_init_rank 275
+#define i2c_dev_init_rank 276
+#define i2c_i801_init_rank 277
+#define smbus_sch_driver_init_rank 278
+#define i2c_mux_gpio_driver_init_rank 279
+#define intel_idle_init_rank 280
+#define simtec_i2c_driver_init_rank 281
+#define evdev_init_rank 282
+#define gspca_init_rank 283
+#define uvc_init_rank 284
+#define ptp_pch_init_rank 285
+#define phy_module_init_rank 286
+#define init_sg_rank 287
+#define sbf_init_rank 288
+#define setup_vmstat_rank 289
+#define extfrag_debug_init_rank 290
+#define proc_filesystems_init_rank 291
+#define dio_init_rank 292
+#define init_autofs4_fs_rank 293
+#define configfs_init_rank 294
+#define init_devpts_fs_rank 295
+#define init_ext2_fs_rank 296
+#define init_nls_cp437_rank 297
+#define init_nls_cp850_rank 298
+#define init_nls_cp852_rank 299
+#define dnotify_init_rank 300
+#define init_nls_ascii_rank 301
+#define init_nls_iso8859_1_rank 302
+#define init_nls_utf8_rank 303
+#define inotify_user_setup_rank 304
+#define proc_locks_init_rank 305
+#define init_udf_fs_rank 306
+#define proc_genhd_init_rank 307
+#define noop_init_rank 308
+#define deadline_init_rank 309
+#define cfq_init_rank 310
+#define init_dns_resolver_rank 311
+#define sock_diag_init_rank 312
+#define cubictcp_register_rank 313
+#define packet_init_rank 314
+#define slab_proc_init_rank 315
+#define workingset_init_rank 316
+#define hugetlb_init_rank 317
+#define proc_vmalloc_init_rank 318
+#define ikconfig_init_rank 319
+#define percpu_counter_startup_rank 320
+#define pcips2_driver_init_rank 321
+#define sermouse_drv_init_rank 322
+#define serio_raw_drv_init_rank 323
+#define oprofile_init_rank 324
+#define add_pcspkr_rank 325
+#define acpi_smb_hc_driver_init_rank 326
+#define nforce2_init_rank 327
+#define snd_compress_init_rank 328
+#define pcspkr_platform_driver_init_rank 329
+#define deinterlace_pdrv_init_rank 330
+#define none_rank 331
+#define grp_none_rank 341
+#define grp_hid_rank 333
+#define grp_dma_rank 334
+#define grp_usb_rank 335
+#define grp_snd_hda_rank 336
+#define intel_cqm_init_rank 337
+#define amd_ibs_init_rank 338
+#define pmc_atom_init_rank 339
+#define alsa_sound_last_init_rank 340
+
+#endif /* ASYNC_MINIT_ORDER_H_ */
@@ -0,0 +1,193 @@
+/*
+ * async-order.cpp
+ *
+ * Link order of async initcalls, every module after its parents and members before their group,
+ * ready modules by priority (cost hints, critical first) like the task list is sorted at boot.
+ * Output is linux/async_minit_order.h, ASYNC_INITCALLS_ORDER lists one input section per module
+ * for ASYNC_INITCALLS in vmlinux.lds.h, ASYNC_DEFERRED_TEXT lists the generated driver init text of
+ * deferred modules for the deferred init memory part and x_rank gives the position of every id,
+ * async.c checks at compile time that every parent has a lower rank, a cycle can not be ranked.
+ * Without a path the header goes to stdout, with one it is written to path.tmp and renamed over path,
+ * exit code is 1 and path is left as it was when the dependency table has a cycle or writing fails.
+ *
+ *  async-order ../src/include/linux/async_minit_order.h
+ *  async-order | diff - ../src/include/linux/async_minit_order.h
+ */
+
+#define TEST
+#define ASYNC_MINIT_ORDER_H_        // ranks are being built, do not check the old ones
+
+#include "linux/async_minit.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+
+#include "kstub.h"
+
+int do_one_initcall(initcall_t fnc)
+{
+    return 0;
+}
+
+#include "../src/drivers/async.c"
+
+#define INI_FNC(id,...) { id ## _id, 0 },
+static struct init_fn_t_4 list_full[] = { MODULES_ID(INI_FNC) };
+
+static std::vector<unsigned> children[module_last];
+static unsigned parents_left[module_last];
+
+static void AddEdge(modules_e parent, modules_e child)
+{
+    children[parent].push_back(child);
+    ++parents_left[child];
+}
+
+/*
+ * Kahn's algorithm, ready ids are taken by priority then by id.
+ * Return how many ids were ranked, less than module_last when there is a cycle
+ */
+static unsigned Rank(const unsigned* prio, modules_e* order)
+{
+    std::set<std::pair<long long, unsigned>> ready;
+    unsigned left[module_last];
+    unsigned count = 0;
+    unsigned id;
+    memcpy(left, parents_left, sizeof(left));
+    for (id = 0; id < module_last; ++id)
+    {
+        if (left[id] == 0)
+            ready.insert(std::make_pair(-(long long) prio[id], id));
+    }
+    while (!ready.empty())
+    {
+        id = ready.begin()->second;
+        ready.erase(ready.begin());
+        order[count++] = (modules_e) id;
+        for (auto child : children[id])
+        {
+            if (--left[child] == 0)
+                ready.insert(std::make_pair(-(long long) prio[child], child));
+        }
+    }
+    return count;
+}
+
+/*
+ * Print one cycle among ids that could not be ranked
+ */
+static void PrintCycle(const modules_e* order, unsigned ranked)
+{
+    std::vector<char> done(module_last, 0);
+    std::vector<unsigned> path;
+    unsigned id;
+    for (id = 0; id < ranked; ++id)
+        done[order[id]] = 1;
+    for (id = 0; done[id]; ++id)
+        ;
+    // every id left has a parent left, walking up them closes a cycle
+    while (std::find(path.begin(), path.end(), id) == path.end())
+    {
+        path.push_back(id);
+        for (unsigned parent = 0; parent < module_last; ++parent)
+        {
+            if (!done[parent] && std::find(children[parent].begin(), children[parent].end(), id) != children[parent].end())
+            {
+                id = parent;
+                break;
+            }
+        }
+    }
+    fprintf(stderr, "dependency cycle:");
+    for (auto it = std::find(path.begin(), path.end(), id); it != path.end(); ++it)
+        fprintf(stderr, " %s <-", getName((modules_e) *it));
+    fprintf(stderr, " %s\n", getName((modules_e) id));
+}
+
+int main(int argc, char* argv[])
+{
+    static unsigned prio[module_last];
+    static modules_e order[module_last];
+    std::string tmp;
+    FILE* out = stdout;
+    int failed;
+    const struct init_fnc_info_4* nfo;
+    unsigned ranked;
+    unsigned id;
+    unsigned idx;
+    for (id = 0; id < module_last; ++id)
+    {
+        nfo = &init_info[id];
+        for (idx = nfo->parents; idx != nfo->parents + nfo->parents_count; ++idx)
+        {
+            if (init_parents[idx] != none_id && init_parents[idx] != grp_none_id)
+                AddEdge(init_parents[idx], (modules_e) id);
+        }
+        if (nfo->grp_id != grp_none_id && nfo->grp_id != id)
+            AddEdge((modules_e) id, nfo->grp_id);
+    }
+    // without priorities first, FillTasks can not walk a cycle
+    ranked = Rank(prio, order);
+    if (ranked != module_last)
+    {
+        PrintCycle(order, ranked);
+        return 1;
+    }
+    FillTasks(list_full, list_full + sizeof(list_full) / sizeof(*list_full));
+    for (id = 0; id < module_last; ++id)
+        prio[id] = info_4[id].prio;
+    Rank(prio, order);
+    if (argc > 1)
+    {
+        tmp = std::string(argv[1]) + ".tmp";
+        out = fopen(tmp.c_str(), "w");
+        if (out == NULL)
+        {
+            fprintf(stderr, "%s: %s\n", tmp.c_str(), strerror(errno));
+            return 1;
+        }
+    }
+    fprintf(out, "/*\n"
+            " * Generated by utils/async-order from the dependency table in drivers/async.c, do not edit.\n"
+            " * Async initcalls are linked in dependency order, parents first and ready ones by priority\n"
+            " */\n\n"
+            "#ifndef ASYNC_MINIT_ORDER_H_\n"
+            "#define ASYNC_MINIT_ORDER_H_\n\n"
+            "#define ASYNC_INITCALLS_ORDER \\\n");
+    for (idx = 0; idx < module_last; ++idx)
+    {
+        if (init_info[order[idx]].type != disable)
+            fprintf(out, "\t*(.async_initcall.init.%s) \\\n", getName(order[idx]));
+    }
+    fprintf(out, "\n#define ASYNC_DEFERRED_TEXT \\\n");
+    for (idx = 0; idx < module_last; ++idx)
+    {
+        if (init_info[order[idx]].type == deferred)
+            fprintf(out, "\t*(.init.text.async.%s) \\\n", getName(order[idx]));
+    }
+    fprintf(out, "\n");
+    for (idx = 0; idx < module_last; ++idx)
+    {
+        // grp_none is the group of modules without one, it comes after all of them
+        fprintf(out, "#define %s_rank %u\n", getName(order[idx]), order[idx] == grp_none_id ? module_last : idx);
+    }
+    fprintf(out, "\n#endif /* ASYNC_MINIT_ORDER_H_ */\n");
+    if (out == stdout)
+        return 0;
+    failed = ferror(out);
+    if (fclose(out) != 0 || failed || rename(tmp.c_str(), argv[1]) != 0)
+    {
+        fprintf(stderr, "%s: %s\n", argv[1], strerror(errno));
+        unlink(tmp.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -7,6 +7,17 @@
  *      Author: lester
  *  g++ -std=c++11 -g
  *  dot -Tpng  -o sample.png graphviz-queue.dot
+ *
+ *  build-depends --header modules.dep [overrides] > async_minit_depends.h
+ *  emits MOD_IDS_DEPENDS and _nfo definitions from the reduced graph instead of graphviz,
+ *  a reference to update MOD_IDS of async_minit.h and the _nfo table of async.c by hand,
+ *  the kernel build does not include it.
+ *  Override lines are "module.ko type [id [group]]", type - keeps asynchronized,
+ *  id defaults to the module name with '-' as '_', mod_ prefixed when it starts with a digit
+ *
+ *  build-depends --profile modules.dep [initcall_log [overrides]]
+ *  reports modules by topological level, maximum antichain width and the longest chain,
+ *  weighted with initcall_debug usecs when a log is given, to size CONFIG_ASYNCHRO_MODULE_INIT_THREADS
  */
 
 #include <vector>
@@ -17,6 +28,8 @@
 #include <set>
 #include <algorithm>
 #include <cstring>
+#include <sstream>
+#include <cstdint>
 
 enum module_type_t
 {
@@ -91,11 +104,11 @@ enum module_type_t getType(const char* name)
 class Module
 {
 public:
-    Module(const char* n,enum module_type_t t) : name_(n), type_(t)
+    Module(const char* n,enum module_type_t t,unsigned i = 0) : name_(n), type_(t), index_(i)
     {
 
     }
-    Module(const Module& m) : name_(m.name_), type_(m.type_)
+    Module(const Module& m) : name_(m.name_), type_(m.type_), index_(m.index_)
     {
 
     }
@@ -105,6 +118,7 @@ public:
     }
     std::string name_;
     module_type_t type_;
+    unsigned index_;        // position in dense graph tables
     template<class T>
     bool operator ==(const T& m) const
     {
@@ -116,53 +130,456 @@ public:
     }
 };
 
+/**
+ * Graph indexed by Module::index_, ancestors holds one bit for every module reached from a node
+ */
+typedef std::vector<uint64_t> Bitset;
+
 static std::set<Module> modules;
-static std::map<const Module*, std::vector<const Module*>> depends;
+static std::vector<std::vector<const Module*>> depends;
+static std::vector<Bitset> ancestors;
+static std::vector<const Module*> topological;       // dependencies first, independent ones by name
 
 /**
  * Find internal char* base on external one
  */
 const Module* getModule(const char* name)
 {
-    auto it = std::find(modules.begin(),modules.end(),name);
-    if (it == modules.end())
-    {
-        it = modules.insert(modules.begin(), Module(name,getType(name)));
-    }
-    return &(*it);
+    auto it = modules.insert(Module(name, getType(name), modules.size()));
+    if (it.second)
+        depends.emplace_back();
+    return &(*it.first);
 }
 
 std::vector<const Module*>& getModuleDependencies(const Module* name)
 {
-    return depends[name];
+    return depends[name->index_];
 }
 
 bool DependsOn(const Module* name,const Module* depends_on)
 {
-    if (depends_on != nullptr)
+    return depends_on != nullptr && (ancestors[name->index_][depends_on->index_ / 64] >> (depends_on->index_ % 64) & 1) != 0;
+}
+
+/**
+ * Ancestors of a node are its dependencies and their ancestors, each node is done once after all its dependencies.
+ * A cycle is reported and the edge closing it is ignored
+ */
+void Visit(const Module* m, std::vector<char>& state)
+{
+    Bitset& a = ancestors[m->index_];
+    if (state[m->index_] != 0)
+    {
+        if (state[m->index_] == 1)
+            std::cerr << "dependency cycle at " << m->name_ << std::endl;
+        return;
+    }
+    state[m->index_] = 1;
+    for (auto d : depends[m->index_])
+    {
+        Visit(d, state);
+        a[d->index_ / 64] |= uint64_t(1) << (d->index_ % 64);
+        for (size_t w = 0; w != a.size(); ++w)
+            a[w] |= ancestors[d->index_][w];
+    }
+    state[m->index_] = 2;
+    topological.push_back(m);
+}
+
+void BuildAncestors()
+{
+    std::vector<char> state(modules.size());
+    ancestors.assign(modules.size(), Bitset((modules.size() + 63) / 64));
+    topological.clear();
+    for (auto& m : modules)
+        Visit(&m, state);
+}
+
+/**
+ * Remove dependencies reached through another one, the union of their ancestors has all of them
+ */
+void Reduce(std::vector<const Module*>& v)
+{
+    Bitset reached((modules.size() + 63) / 64);
+    for (auto d : v)
+    {
+        for (size_t w = 0; w != reached.size(); ++w)
+            reached[w] |= ancestors[d->index_][w];
+    }
+    v.erase(std::remove_if(v.begin(), v.end(), [&](const Module* d)
+    {   return (reached[d->index_ / 64] >> (d->index_ % 64) & 1) != 0;}), v.end());
+}
+
+/**
+ * Forced type, init function name and group of a module
+ */
+struct Override
+{
+    std::string type_;
+    std::string id_;
+    std::string group_;
+};
+
+static std::map<std::string, Override> overrides;       // by module name with '-' as '_'
+
+/**
+ * Module names use '-' and '_' for the same thing
+ */
+std::string getKey(std::string name)
+{
+    std::replace(name.begin(), name.end(), '-', '_');
+    return name;
+}
+
+bool LoadOverrides(const char* file_name)
+{
+    static const char* const types[] = { "-", "asynchronized", "deferred", "critical", "disable" };
+    std::ifstream fs(file_name);
+    std::string line;
+    std::string name;
+    Override o;
+    if (!fs)
+        return false;
+    while (std::getline(fs, line))
     {
-        auto &v = depends[name];
-        for (auto d : v)
+        std::istringstream is(line);
+        o = Override();
+        if (!(is >> name) || name[0] == '#')
+            continue;
+        is >> o.type_ >> o.id_ >> o.group_;
+        if (std::find(types, types + sizeof(types) / sizeof(*types), o.type_) == types + sizeof(types) / sizeof(*types))
         {
-            if (d == depends_on)
-                return true;
-            if (DependsOn(d, depends_on))
+            std::cerr << file_name << ": unknown type " << o.type_ << " for " << name << std::endl;
+            return false;
+        }
+        overrides[getKey(name)] = o;
+    }
+    return true;
+}
+
+/**
+ * Init function id of a module
+ */
+std::string getId(const Module* m)
+{
+    auto it = overrides.find(getKey(m->name_));
+    if (it != overrides.end() && !it->second.id_.empty())
+        return it->second.id_;
+    std::string id = getKey(m->name_.substr(0, m->name_.size() - strlen(".ko")));
+    std::replace_if(id.begin(), id.end(), [](char c) { return !isalnum(c); }, '_');
+    return isdigit(id[0]) ? "mod_" + id : id;
+}
+
+/**
+ * Nearest module dependencies, library modules are crossed and subsystems are already done
+ */
+void AddParents(const Module* name, std::vector<const Module*>& parents)
+{
+    for (auto d : depends[name->index_])
+    {
+        if (d->type_ == module)
+        {
+            if (std::find(parents.begin(), parents.end(), d) == parents.end())
+                parents.push_back(d);
+        }
+        else if (d->type_ == symbol)
+            AddParents(d, parents);
+    }
+}
+
+/**
+ * Header with MOD_IDS_DEPENDS and _nfo of every module, parents are the transitive reduction of modules.dep.
+ * Nothing includes it, entries are copied to async.c by hand, every _nfo is guarded so a copied
+ * block does not clash with the ones written there.
+ * CALL_FNC takes up to 16 arguments, type and group leave room for 14 parents
+ */
+void PrintHeader(const char* dep_file, const char* override_file)
+{
+    std::vector<const Module*> order;
+    std::vector<const Module*> parents;
+    std::set<std::string> groups;
+    std::string type;
+    std::string group;
+    for (auto m : topological)
+    {
+        if (m->type_ == module)
+            order.push_back(m);
+    }
+    for (auto& o : overrides)
+    {
+        if (!o.second.group_.empty() && o.second.group_ != "grp_none")
+            groups.insert(o.second.group_);
+    }
+    std::cout << "/*\n * Generated by build-depends --header from " << dep_file;
+    if (override_file != nullptr)
+        std::cout << " and " << override_file;
+    std::cout << R"(, do not edit.
+ * Parents are the transitive reduction of module dependencies,
+ * library modules are replaced by their own dependencies and subsystems are left out.
+ * Not included by the build, copy entries missing in MOD_IDS and drivers/async.c from it
+ */
+
+#ifndef ASYNC_MINIT_DEPENDS_H_
+#define ASYNC_MINIT_DEPENDS_H_
+
+#define MOD_IDS_DEPENDS(fnc) \
+    fnc(grp_none) \
+)";
+    for (auto& g : groups)
+        std::cout << "    fnc(" << g << ") \\\n";
+    for (auto m : order)
+        std::cout << "    fnc(" << getId(m) << ") /* " << m->name_ << " */ \\\n";
+    std::cout << "\n#ifndef grp_none_nfo\n#define grp_none_nfo disable\n#endif\n";
+    for (auto& g : groups)
+        std::cout << "#ifndef " << g << "_nfo\n#define " << g << "_nfo disable\n#endif\n";
+    for (auto m : order)
+    {
+        auto it = overrides.find(getKey(m->name_));
+        type = it != overrides.end() && it->second.type_ != "-" ? it->second.type_ : "asynchronized";
+        group = it != overrides.end() && !it->second.group_.empty() ? it->second.group_ : "grp_none";
+        parents.clear();
+        AddParents(m, parents);
+        Reduce(parents);
+        if (parents.size() > 14)
+        {
+            std::cerr << m->name_ << ": " << parents.size() << " parents, only 14 kept" << std::endl;
+            parents.resize(14);
+        }
+        std::cout << "#ifndef " << getId(m) << "_nfo\n#define " << getId(m) << "_nfo " << type;
+        if (group != "grp_none" || !parents.empty())
+            std::cout << "," << group;
+        for (auto p : parents)
+            std::cout << "," << getId(p);
+        std::cout << "   /* " << m->name_ << " */\n#endif\n";
+    }
+    std::cout << "\n#endif /* ASYNC_MINIT_DEPENDS_H_ */\n";
+}
+
+/**
+ * Chain cover matching (Hopcroft-Karp), next[u] is the module following u in its chain,
+ * prev[v] the one before v, dist is the breadth first layer of a module in the current phase
+ */
+struct Matching
+{
+    std::vector<int> next;
+    std::vector<int> prev;
+    std::vector<unsigned> dist;
+};
+
+static const unsigned unlayered = ~0u;
+
+/**
+ * Layers from modules without a next one, true when an augmenting path exists.
+ * reach[u] has every module depending on u, set bits are taken a word at a time
+ */
+bool Layers(const std::vector<Bitset>& reach, Matching& m)
+{
+    std::vector<unsigned> queue;
+    bool found = false;
+    for (unsigned u = 0; u != reach.size(); ++u)
+    {
+        m.dist[u] = m.next[u] < 0 ? 0 : unlayered;
+        if (m.next[u] < 0)
+            queue.push_back(u);
+    }
+    for (size_t head = 0; head != queue.size(); ++head)
+    {
+        unsigned u = queue[head];
+        for (size_t w = 0; w != reach[u].size(); ++w)
+        {
+            for (uint64_t bits = reach[u][w]; bits != 0; bits &= bits - 1)
+            {
+                int before = m.prev[w * 64 + __builtin_ctzll(bits)];
+                if (before < 0)
+                    found = true;
+                else if (m.dist[before] == unlayered)
+                {
+                    m.dist[before] = m.dist[u] + 1;
+                    queue.push_back(before);
+                }
+            }
+        }
+    }
+    return found;
+}
+
+/**
+ * Augmenting path from u following the layers, a module without one is left out until the next phase
+ */
+bool Augment(unsigned u, const std::vector<Bitset>& reach, Matching& m)
+{
+    for (size_t w = 0; w != reach[u].size(); ++w)
+    {
+        for (uint64_t bits = reach[u][w]; bits != 0; bits &= bits - 1)
+        {
+            unsigned v = w * 64 + __builtin_ctzll(bits);
+            int before = m.prev[v];
+            if (before < 0 || (m.dist[before] == m.dist[u] + 1 && Augment(before, reach, m)))
+            {
+                m.next[u] = v;
+                m.prev[v] = u;
                 return true;
+            }
         }
     }
+    m.dist[u] = unlayered;
     return false;
 }
 
+/**
+ * Parallelism profile of the graph --header emits, library modules are crossed and subsystems are left out.
+ * Level is the longest chain of parents before a module.
+ * Maximum antichain, modules that can all run at once, is modules less the minimum chain cover (Dilworth),
+ * the cover is a maximum matching on the transitive closure, O(E sqrt(V)) with Hopcroft-Karp phases.
+ * Without a log every module weights 1, with it modules weight their initcall usecs and the rest 0
+ */
+bool PrintProfile(const char* log_file)
+{
+    std::vector<const Module*> order;
+    std::vector<const Module*> parents;
+    std::map<std::string, unsigned> ids;        // init function id to dense module index
+    std::vector<unsigned> pos(modules.size());  // dense module index of every module
+    std::vector<unsigned> level;
+    std::vector<unsigned> per_level;
+    std::vector<unsigned long> cost;
+    std::vector<unsigned long> path;            // heaviest chain ending at a module
+    std::vector<int> prev;
+    std::vector<Bitset> reach;
+    Matching chains;
+    unsigned long total = 0;
+    unsigned long longest = 0;
+    unsigned timed = 0;
+    unsigned matched = 0;
+    int last = -1;
+    for (auto m : topological)
+    {
+        if (m->type_ != module)
+            continue;
+        pos[m->index_] = order.size();
+        ids[getId(m)] = order.size();
+        order.push_back(m);
+    }
+    cost.assign(order.size(), log_file == nullptr ? 1 : 0);
+    if (log_file != nullptr)
+    {
+        std::ifstream fs(log_file);
+        std::string line;
+        size_t at;
+        size_t end;
+        if (!fs)
+            return false;
+        while (std::getline(fs, line))
+        {
+            at = line.find("initcall ");
+            if (at == std::string::npos || line.find(" returned ") == std::string::npos || line.find(" after ") == std::string::npos)
+                continue;
+            at += strlen("initcall ");
+            end = line.find_first_of("+ ", at);
+            auto it = ids.find(line.substr(at, end - at));
+            if (it == ids.end())
+                continue;
+            if (cost[it->second] == 0)
+                ++timed;
+            cost[it->second] += strtoul(line.c_str() + line.find(" after ") + strlen(" after "), NULL, 10);
+        }
+    }
+    level.assign(order.size(), 0);
+    path.assign(order.size(), 0);
+    prev.assign(order.size(), -1);
+    reach.assign(order.size(), Bitset((order.size() + 63) / 64));
+    for (unsigned idx = 0; idx != order.size(); ++idx)
+    {
+        parents.clear();
+        AddParents(order[idx], parents);
+        for (auto p : parents)
+        {
+            unsigned parent = pos[p->index_];
+            level[idx] = std::max(level[idx], level[parent] + 1);
+            if (path[parent] > path[idx] || prev[idx] < 0)
+            {
+                path[idx] = path[parent];
+                prev[idx] = parent;
+            }
+        }
+        path[idx] += cost[idx];
+        total += cost[idx];
+        if (path[idx] > longest || last < 0)
+        {
+            longest = path[idx];
+            last = idx;
+        }
+        if (level[idx] >= per_level.size())
+            per_level.resize(level[idx] + 1);
+        ++per_level[level[idx]];
+    }
+    // modules depending on each one, children come later in topological order
+    for (unsigned idx = order.size(); idx-- != 0;)
+    {
+        parents.clear();
+        AddParents(order[idx], parents);
+        for (auto p : parents)
+        {
+            Bitset& r = reach[pos[p->index_]];
+            r[idx / 64] |= uint64_t(1) << (idx % 64);
+            for (size_t w = 0; w != r.size(); ++w)
+                r[w] |= reach[idx][w];
+        }
+    }
+    chains.next.assign(order.size(), -1);
+    chains.prev.assign(order.size(), -1);
+    chains.dist.assign(order.size(), unlayered);
+    while (Layers(reach, chains))
+    {
+        for (unsigned idx = 0; idx != order.size(); ++idx)
+        {
+            if (chains.next[idx] < 0 && chains.dist[idx] == 0 && Augment(idx, reach, chains))
+                ++matched;
+        }
+    }
+    std::cout << order.size() << " modules";
+    if (log_file != nullptr)
+        std::cout << ", " << timed << " with timings in " << log_file;
+    std::cout << std::endl;
+    for (unsigned idx = 0; idx != per_level.size(); ++idx)
+        std::cout << "level " << idx << ": " << per_level[idx] << " modules" << std::endl;
+    std::cout << "widest level " << (per_level.empty() ? 0 : *std::max_element(per_level.begin(), per_level.end()))
+            << ", maximum antichain " << order.size() - matched << std::endl;
+    std::cout << "longest chain " << longest << (log_file != nullptr ? " usecs" : " modules") << " of " << total << ":";
+    std::vector<int> chain;
+    for (; last >= 0; last = prev[last])
+        chain.push_back(last);
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+    {
+        std::cout << " " << order[*it]->name_;
+        if (log_file != nullptr)
+            std::cout << "(" << cost[*it] << ")";
+    }
+    std::cout << std::endl;
+    // more threads than work over critical path or than modules able to run at once stay idle
+    std::cout << "threads worth having " << std::max<unsigned long>(1, std::min<unsigned long>(order.size() - matched,
+            longest ? (total + longest - 1) / longest : 1)) << std::endl;
+    return true;
+}
 
 int main(int argc, char* argv[])
 {
+    enum { graph, header, profile } mode = graph;
+    if (argc > 1 && strcmp(argv[1], "--header") == 0)
+        mode = header;
+    else if (argc > 1 && strcmp(argv[1], "--profile") == 0)
+        mode = profile;
+    if (mode != graph)
+    {
+        --argc;
+        ++argv;
+    }
+    const char* override_file = mode == header && argc > 2 ? argv[2] : mode == profile && argc > 3 ? argv[3] : nullptr;
     char    cline[1000];
     if (argc < 2)
     {
         std::cout << "Invalid number of arguments";
         return -1;
     }
-    unsigned index;   // 0 reading main module.
     std::vector<char*> keys;
     char*   key;
     char*   pos;
@@ -172,7 +589,13 @@ int main(int argc, char* argv[])
 
     std::string line;
     std::ifstream fs(argv[1]);
-    std::cout << R"(digraph {
+    if (override_file != nullptr && !LoadOverrides(override_file))
+    {
+        std::cerr << "can not read " << override_file << std::endl;
+        return -1;
+    }
+    if (mode == graph)
+        std::cout << R"(digraph {
     concentrate=true;
     rankdir=TB;
     node [fontsize=10];
@@ -226,13 +649,32 @@ int main(int argc, char* argv[])
         }
         if (keys.size() > 1)
         {
-            auto& v = getModuleDependencies(getModule(keys.front()));
+            const Module* m = getModule(keys.front());
             for (auto it2 = keys.begin() + 1; it2 != keys.end(); ++it2)
             {
-                std::cout << "\"" << *it2 << "\" -> \"" << keys.front() << "\"" << std::endl;
-                v.push_back(getModule(*it2));
+                if (mode == graph)
+                    std::cout << "\"" << *it2 << "\" -> \"" << keys.front() << "\"" << std::endl;
+                const Module* d = getModule(*it2);      // can grow dependencies table
+                auto& v = getModuleDependencies(m);
+                if (std::find(v.begin(), v.end(), d) == v.end())
+                    v.push_back(d);
             }
         }
+        else if (keys.size() == 1)
+            getModule(keys.front());        // no dependencies
+    }
+    BuildAncestors();
+    if (mode == header)
+    {
+        PrintHeader(argv[1], override_file);
+        return 0;
+    }
+    if (mode == profile)
+    {
+        if (PrintProfile(argc > 2 ? argv[2] : nullptr))
+            return 0;
+        std::cerr << "can not read " << argv[2] << std::endl;
+        return -1;
     }
     // Build symbols list
    for(const char* const* ptr = symbols;ptr != symbols + sizeof(symbols)/sizeof(*symbols);++ptr)
@@ -248,35 +690,19 @@ int main(int argc, char* argv[])
    subgraph cluster_1 { 
 )";
     // For each node check it its direct dependencies are found also in another path
-    for (auto mod_it : depends)
+    for (auto& m : modules)
     {
+        auto v = depends[m.index_];
         // check only multiple dependencies module
-        if (mod_it.second.size() > 1)
-        {
-            // for each direct dependency
-            for (auto& it1 : mod_it.second)
-            {
-                // check if it1 is included from it2
-                for (auto& it2 : mod_it.second)
-                {
-                    if ((it1 != it2) && DependsOn(it2, it1))
-                    {
-                        it1 = nullptr;
-                        break;
-                    }
-                }
-            }
-            // remove all nullptr generated
-            auto it = std::remove(mod_it.second.begin(), mod_it.second.end(),nullptr);
-            mod_it.second.erase(it,mod_it.second.end());
-        }
+        if (v.size() > 1)
+            Reduce(v);
         // print out
-        for (auto it1 : mod_it.second)
+        for (auto it1 : v)
         {
             // print only dependencies on module type
             if (it1->type_ == module)
             {
-                std::cout << "\"" << it1->name_ << ".2\" -> \"" << mod_it.first->name_ << ".2\"" << std::endl;
+                std::cout << "\"" << it1->name_ << ".2\" -> \"" << m.name_ << ".2\"" << std::endl;
             }
         }
     }
@@ -0,0 +1,445 @@
+/*
+ * kstub.h
+ * Kernel primitives used by async.c mapped to single thread userspace code,
+ * with KSTUB_THREADS defined they are mapped to std::atomic, std::mutex, std::condition_variable
+ * and std::thread so working threads really run in parallel
+ *
+ *  Created on: 27 Apr 2015
+ *      Author: lester
+ */
+
+#ifndef UTILS_KSTUB_H_
+#define UTILS_KSTUB_H_
+
+#define __u64   uint64_t
+#define u64     uint64_t
+
+#ifndef KSTUB_THREADS
+
+#define ATOMIC_INIT(a)      a
+#define atomic_t unsigned
+
+#define atomic_set(a,b)  *a = b
+#define atomic_read(a)   *a
+#define atomic_inc(a)    ++(*a)
+#define atomic_dec(a)    --(*a)
+#define clear_bit(b,v)   (*v) &= ~(1 << b)
+#define set_bit(b,v)     (*v) |= (1 << b)
+#define atomic_dec_and_test(a)  (--(*a) == 0)
+#define atomic_inc_return(a)    (++(*a))
+#define atomic_dec_return(a)    (--(*a))
+#define atomic_inc_not_zero(a)  (*a != 0 ? ++(*a) : 0)
+#define atomic_add(i,a)  (*a) += (i)
+
+unsigned test_and_set_bit(unsigned b,  volatile unsigned long * v)
+{
+    unsigned r = ((*v) & (1UL << b)) != 0;
+    set_bit(b,v);
+    return r;
+}
+
+unsigned test_and_clear_bit(unsigned b,  volatile unsigned long * v)
+{
+    unsigned r = ((*v) & (1UL << b)) != 0;
+    clear_bit(b,v);
+    return r;
+}
+
+int atomic_xchg(atomic_t* v,int n)
+{
+    int a = *v;
+    *v = n;
+    return a;
+}
+
+int atomic_cmpxchg(atomic_t* v,int o,int n)
+{
+    int a = *v;
+    if (a == o)
+        *v = n;
+    return a;
+}
+
+/*
+ * Nothing waits or runs apart, stubs still take their wait queue, condition and thread function
+ * so everything async.c declares for them is used
+ */
+static inline int kstub_wait(const void* wq, bool condition)
+{
+    return 0;
+}
+
+struct task_struct;
+static inline struct task_struct* kstub_thread(int (*fnc)(void*))
+{
+    return NULL;
+}
+
+#define __wake_up(...)
+#define schedule(...)
+#define prepare_to_wait_for(...)
+#define finish_wait(...)
+#define spin_lock(...)
+#define spin_unlock(...)
+#define wake_up_interruptible(wq)           ((void) (wq))
+#define wake_up_interruptible_all(wq)       ((void) (wq))
+#define num_online_cpus(...) 1
+#define kthread_create(fnc,...)             kstub_thread(fnc)
+#define kthread_run(fnc,...)                kstub_thread(fnc)
+#define wait_event_interruptible(wq,condition)  kstub_wait(&(wq), (condition))
+#define wait_event(wq,condition)                kstub_wait(&(wq), (condition))
+#define wait_event_interruptible_exclusive(wq,condition)            kstub_wait(&(wq), (condition))
+#define wait_event_interruptible_timeout(wq,condition,timeout)      kstub_wait(&(wq), (condition))
+#define kthread_stop(...)
+#define smp_wmb()
+#define smp_rmb()
+#define wake_up_interruptible_nr(wq,nr)     ((void) (wq))
+#define READ_ONCE(x) (x)
+#define WRITE_ONCE(x,v) (x) = (v)
+#define msleep(...)
+#define free_initmem(...)
+static unsigned kstub_areas_freed;      // free_reserved_area calls
+#define free_reserved_area(...)     (++kstub_areas_freed, 0UL)
+#define ERR_PTR(...) NULL
+#define IS_ERR(p) ((p) == NULL)
+//#define ENOMEM 6
+//#define kthread_create_on_node(...) 0
+#define kthread_bind(thr,cpu)   ((void) (thr), (void) (cpu))
+#define wake_up_process(thr)    ((void) (thr))
+#define printk(...) printf( __VA_ARGS__ )
+#define _raw_spin_lock(...)
+
+#define DEFINE_SPINLOCK(a) int a
+typedef int spinlock_t;
+#define spin_lock_init(...)
+#define DEFINE_MUTEX(a) int a
+#define mutex_lock(l)   ((void) (l))
+#define mutex_unlock(l) ((void) (l))
+#define DECLARE_WAIT_QUEUE_HEAD(a) int a
+
+struct task_struct { long state; };
+#define current                 ((struct task_struct*) NULL)
+
+struct completion { unsigned done; };
+#define DECLARE_COMPLETION(x)       struct completion x
+#define complete_all(x)             ((x)->done = 1)
+#define reinit_completion(x)        ((x)->done = 0)
+#define wait_for_completion(...)
+
+u64 local_clock(void)
+{
+    static u64 clock = 0;
+    return ++clock;
+}
+#define raw_smp_processor_id()  0
+
+#else
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <sched.h>
+
+typedef struct { std::atomic<int> counter; } atomic_t;
+#define ATOMIC_INIT(i)          { { i } }
+
+#define atomic_set(v,i)         ((v)->counter.store(i))
+#define atomic_read(v)          ((v)->counter.load())
+#define atomic_inc(v)           ((v)->counter.fetch_add(1))
+#define atomic_dec(v)           ((v)->counter.fetch_sub(1))
+#define atomic_dec_and_test(v)  (atomic_dec_return(v) == 0)
+#define atomic_xchg(v,i)        ((v)->counter.exchange(i))
+#define atomic_add(i,v)         ((v)->counter.fetch_add(i))
+
+static inline int atomic_inc_return(atomic_t* v)
+{
+    return v->counter.fetch_add(1) + 1;
+}
+
+static inline int atomic_dec_return(atomic_t* v)
+{
+    return v->counter.fetch_sub(1) - 1;
+}
+
+static inline int atomic_inc_not_zero(atomic_t* v)
+{
+    int c = v->counter.load();
+    while (c != 0 && !v->counter.compare_exchange_weak(c, c + 1))
+        ;
+    return c != 0;
+}
+
+static inline int atomic_cmpxchg(atomic_t* v, int o, int n)
+{
+    v->counter.compare_exchange_strong(o, n);
+    return o;       // old value either way
+}
+
+#define READ_ONCE(x)            __atomic_load_n(&(x), __ATOMIC_RELAXED)
+#define WRITE_ONCE(x,v)         __atomic_store_n(&(x), (v), __ATOMIC_RELAXED)
+
+/*
+ * Waker notifies holding the lock, a waiter checking its condition is either before
+ * the change or already sleeping. Last thread going out can not touch a wait queue already gone
+ */
+struct wait_queue_head_t
+{
+    std::mutex lock;
+    std::condition_variable cond;
+};
+#define DECLARE_WAIT_QUEUE_HEAD(name)   wait_queue_head_t name
+#define DEFINE_SPINLOCK(name)           std::mutex name
+typedef std::mutex spinlock_t;
+#define spin_lock_init(l)               ((void) (l))
+#define spin_lock(l)                    (l)->lock()
+#define spin_unlock(l)                  (l)->unlock()
+#define DEFINE_MUTEX(name)              std::mutex name
+#define mutex_lock(l)                   (l)->lock()
+#define mutex_unlock(l)                 (l)->unlock()
+
+#define wait_event(wq,condition) \
+    ([&]() { std::unique_lock<std::mutex> l((wq).lock); (wq).cond.wait(l, [&]() { return bool(condition); }); return 0; }())
+#define wait_event_interruptible(wq,condition)              wait_event(wq,condition)
+#define wait_event_interruptible_exclusive(wq,condition)    wait_event(wq,condition)
+#define wait_event_interruptible_timeout(wq,condition,timeout) \
+    ([&]() { std::unique_lock<std::mutex> l((wq).lock); \
+        return (wq).cond.wait_for(l, std::chrono::milliseconds(timeout), [&]() { return bool(condition); }) ? 1 : 0; }())
+#define smp_wmb()               std::atomic_thread_fence(std::memory_order_release)
+#define smp_rmb()               std::atomic_thread_fence(std::memory_order_acquire)
+
+static inline void wake_up_nr(wait_queue_head_t* wq, unsigned nr)
+{
+    std::lock_guard<std::mutex> l(wq->lock);
+    if (nr == 0)
+        wq->cond.notify_all();
+    else
+        while (nr-- != 0)
+            wq->cond.notify_one();
+}
+#define wake_up_interruptible(wq)           wake_up_nr(wq, 1)
+#define wake_up_interruptible_all(wq)       wake_up_nr(wq, 0)
+#define wake_up_interruptible_nr(wq,nr)     wake_up_nr(wq, nr)
+
+struct completion
+{
+    wait_queue_head_t wait;
+    std::atomic<int> done;
+};
+#define DECLARE_COMPLETION(x)       struct completion x
+#define wait_for_completion(x)      wait_event((x)->wait, (x)->done.load() != 0)
+#define reinit_completion(x)        ((x)->done.store(0))
+
+static inline void complete_all(struct completion* x)
+{
+    x->done.store(1);
+    wake_up_nr(&x->wait, 0);
+}
+
+/*
+ * Thread is created stopped, wake_up_process runs it detached.
+ * A task_struct is never freed, its state can be read after the thread is gone like under rcu_read_lock
+ */
+struct task_struct
+{
+    int (*fnc)(void*);
+    void* data;
+    long state;                 // TASK_RUNNING, code under test marks itself blocked while it sleeps
+};
+
+static thread_local task_struct* kstub_current;
+#define current                 kstub_current
+
+extern unsigned kstub_cpus;         // online cpus seen by async.c
+#define num_online_cpus()       kstub_cpus
+#define kthread_create(fnc,data,...)    (new task_struct { fnc, data })
+#define kthread_bind(thr,cpu)   ((void) (cpu))
+#define IS_ERR(p)               ((p) == NULL)
+
+static inline void wake_up_process(task_struct* thr)
+{
+    std::thread([thr]() { kstub_current = thr; thr->fnc(thr->data); }).detach();
+}
+
+static inline void kthread_stop(task_struct* thr)
+{
+    delete thr;         // never woken, its function does not run
+}
+
+static inline task_struct* kthread_run(int (*fnc)(void*), void* data, const char* name)
+{
+    task_struct* thr = new task_struct { fnc, data };
+    wake_up_process(thr);
+    return thr;
+}
+
+#define schedule()              std::this_thread::yield()
+#define msleep(m)               std::this_thread::sleep_for(std::chrono::milliseconds(m))
+#define free_initmem(...)
+static std::atomic<unsigned> kstub_areas_freed;     // free_reserved_area calls
+#define free_reserved_area(...)     (++kstub_areas_freed, 0UL)
+#define printk(...)             printf( __VA_ARGS__ )
+
+static inline u64 local_clock(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#define raw_smp_processor_id()  sched_getcpu()
+
+#endif
+
+const struct init_fn_t_4 *__async_initcall_start;
+const struct init_fn_t_4 *__async_initcall_end;
+char *__init_begin, *__init_end;        // init memory parts, all empty unless a test sets them
+char *__deferred_text_begin, *__deferred_text_end;
+char *__async_minit_text_begin, *__async_minit_text_end, *__async_minit_data_begin, *__async_minit_data_end;
+//struct dependency_t __async_modules_depends_start[]  = {
+//        MOD_DEPENDENCY_ITEM(snd_hrtimer_init,alsa_timer_init),
+//        MOD_DEPENDENCY_ITEM(alsa_mixer_oss_init,alsa_pcm_init),       //snd-mixer-oss
+//        MOD_DEPENDENCY_ITEM(alsa_pcm_oss_init,alsa_mixer_oss_init),   // snd-pcm-oss
+//        MOD_DEPENDENCY_ITEM(alsa_hwdep_init,alsa_pcm_init),
+//        MOD_DEPENDENCY_ITEM(alsa_seq_device_init,alsa_timer_init),
+//        MOD_DEPENDENCY_ITEM(alsa_seq_init,alsa_seq_device_init),
+//        MOD_DEPENDENCY_ITEM(alsa_seq_midi_event_init,alsa_seq_init),
+//        MOD_DEPENDENCY_ITEM(alsa_seq_dummy_init,alsa_seq_init),
+//        MOD_DEPENDENCY_ITEM(alsa_seq_oss_init,alsa_seq_midi_event_init),
+//        // multiple dependencie
+//        MOD_DEPENDENCY_ITEM(crypto_xcbc_module_init,init_cifs),
+//        MOD_DEPENDENCY_ITEM(crypto_xcbc_module_init,drm_fb_helper_modinit),
+//        MOD_DEPENDENCY_ITEM(crypto_xcbc_module_init,acpi_power_meter_init),
+//
+//        MOD_DEPENDENCY_ITEM(init_cifs,usblp_driver_init),
+//        MOD_DEPENDENCY_ITEM(init_cifs,acpi_power_meter_init)
+//        };
+//struct dependency_t __async_modules_depends_end[0];// = __async_modules_depends_start + 14;
+
+#define module_init(fnc)    static int (* const fnc ## _ref)(void) __attribute__((unused)) = fnc;
+#define __initcall(...)   ;
+#define late_initcall_sync(...)   ;
+
+#ifndef __used
+#define __used
+#endif
+
+
+#define KERN_ERR ""
+#define KERN_EMERG ""
+//#define EFAULT 5
+
+# define __user
+#define loff_t  unsigned
+#define ssize_t unsigned
+#define copy_to_user(to,from,n)   (memcpy(to,from,n),0)
+#define copy_from_user(to,from,n)   (memcpy(to,from,n),0)
+#define get_user(x,p)   ((x) = *(p), 0)
+#define EXPORT_SYMBOL(...)
+#define msecs_to_jiffies(m)         (m)         // HZ 1000
+#define DEFINE_PER_CPU(type,name)   type name[64]
+#define per_cpu(name,cpu)           ((name)[cpu])
+// online cpus have even ids, code assuming 0 .. num_online_cpus() - 1 uses offline ones
+#define cpu_online_mask             NULL
+#define nr_cpu_ids                  (2 * num_online_cpus())
+#define cpumask_next(n,mask)        ((unsigned) (((int) (n) + 2) & ~1))
+#define for_each_online_cpu(cpu)    for ((cpu) = -1; (cpu) = cpumask_next((cpu), cpu_online_mask), (cpu) < nr_cpu_ids;)
+#define EFAULT 14
+#define ENODEV 19
+#define ERESTARTSYS 512
+#define O_NONBLOCK 04000
+
+ssize_t simple_read_from_buffer(void *to, size_t count, loff_t *ppos, const void *from, size_t available)
+{
+    if (*ppos >= available)
+        return 0;
+    if (count > available - *ppos)
+        count = available - *ppos;
+    memcpy(to, (const char*)from + *ppos, count);
+    *ppos += count;
+    return count;
+}
+
+#define min(a,b)    ((a) < (b) ? (a) : (b))
+
+#define __init
+#define __initdata
+#define __initconst
+#define __ref
+#define __weak __attribute__((weak))
+#define POISON_FREE_INITMEM 0xcc
+
+struct file
+{
+    const void* private_data;
+    unsigned f_flags;
+};
+
+typedef struct poll_table_struct poll_table;
+#define poll_wait(...)
+#define POLLIN      0x0001
+#define POLLRDNORM  0x0040
+
+struct file_operations
+{
+    int (*open)(struct inode *, struct file * );
+    unsigned int (*read)(struct file*,char*,size_t,unsigned int*);
+    unsigned int (*write)(struct file*,const char*,size_t,unsigned int*);
+    unsigned int (*poll)(struct file*,poll_table*);
+};
+
+static inline void* proc_create(const char* name, int mode, void* parent, const struct file_operations* fops)
+{
+    return NULL;
+}
+
+/*
+ * Files are read with stdio, a path that can not be opened is an error
+ */
+#ifndef O_RDONLY
+#define O_RDONLY 0
+#endif
+#define GFP_KERNEL                  0
+#define kfree(p)                    free(p)
+#define simple_strtoul(s,e,b)       strtoul(s,e,b)
+#define simple_strtol(s,e,b)        strtol(s,e,b)
+#define __setup(str,fnc)            static int (* const fnc ## _ref)(char*) __attribute__((unused)) = fnc;
+
+static inline char* kmalloc(size_t size, int flags)
+{
+    return (char*) malloc(size);
+}
+
+static inline struct file* filp_open(const char* name, int flags, int mode)
+{
+    static struct file f;
+    f.private_data = fopen(name, "rb");
+    return f.private_data != NULL ? &f : NULL;
+}
+
+static inline int kernel_read(struct file* f, loff_t offset, char* buf, unsigned long count)
+{
+    FILE* s = (FILE*) f->private_data;
+    return fseek(s, offset, SEEK_SET) == 0 ? fread(buf, 1, count, s) : -1;
+}
+#define filp_close(f,id)            fclose((FILE*) (f)->private_data)
+
+/*
+ * Threads keep their priority, the run queue is never busy and only working threads can be blocked
+ */
+#include <sched.h>
+#ifndef SCHED_IDLE
+#define SCHED_IDLE                  5
+#endif
+static inline int sched_setscheduler_nocheck(struct task_struct* p, int policy, const struct sched_param* param)
+{
+    return 0;
+}
+#define nr_running()                0UL
+#define div_u64(a,b)                ((a) / (b))
+#define TASK_RUNNING                0
+#define TASK_UNINTERRUPTIBLE        2
+#define rcu_read_lock()
+#define rcu_read_unlock()
+
+atomic_t free_init_ref = ATOMIC_INIT(0);
+
+#endif /* UTILS_KSTUB_H_ */
@@ -0,0 +1,37 @@
+/*
+ * pci.h
+ * Present devices are the ones in kstub_pci_devs, tests fill it from an lspci -nn dump
+ */
+
+#ifndef UTILS_LINUX_PCI_H_
+#define UTILS_LINUX_PCI_H_
+
+#define CONFIG_PCI 1
+#define PCI_ANY_ID (~0U)
+#define class pci_class         // C++ keyword, kernel code reads dev->class
+
+struct pci_dev
+{
+    unsigned short vendor;
+    unsigned short device;
+    unsigned int class;         // base class, subclass and programming interface
+};
+
+enum { kstub_pci_max = 256 };
+static struct pci_dev kstub_pci_devs[kstub_pci_max];
+static unsigned kstub_pci_count;
+
+static inline struct pci_dev* pci_get_device(unsigned vendor, unsigned device, struct pci_dev* from)
+{
+    struct pci_dev* dev = from ? from + 1 : kstub_pci_devs;
+    for (; dev != kstub_pci_devs + kstub_pci_count; ++dev)
+    {
+        if ((vendor == PCI_ANY_ID || vendor == dev->vendor) && (device == PCI_ANY_ID || device == dev->device))
+            return dev;
+    }
+    return NULL;
+}
+
+#define for_each_pci_dev(d) while ((d = pci_get_device(PCI_ANY_ID, PCI_ANY_ID, d)) != NULL)
+
+#endif /* UTILS_LINUX_PCI_H_ */
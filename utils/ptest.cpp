@@ -0,0 +1,536 @@
+/*
+ * ptest.cpp
+ *
+ * Parallel test, async.c working threads run on std::thread with real atomics and wait queues.
+ * Every module id is registered with a synthetic initcall that sleeps or spins,
+ * each initcall checks at start that all its parents and group members are done.
+ * Both stages are run on working threads, deferred one by a write to deferred_initcalls,
+ * a second writer with its own open waits for it and a read opened after it is at end of file,
+ * and repeated with 1,2,4,8,16 workers.
+ * A failing module returns -ENODEV, everything depending on it must be skipped.
+ * A class or module name is written to deferred_initcalls while asynchronized stage runs, it must be done
+ * with all its parents when the demand returns, then a misc node is opened like misc_open does for
+ * a minor without driver and every module serving its major must be done. Critical tasks are done or skipped
+ * when critical_done is completed, like kernel_init waits for them before mounting root.
+ * Deferred initcalls have their code in the deferred init memory part, generic part must be
+ * released after asynchronized stage when no task with code there is left, all parts at the end.
+ * Locality is the share of tasks run by the same worker as their last finished parent.
+ * Online cpus of kstub.h have even ids, working threads must take distinct ones.
+ * No PCI device is present, drivers with PCI ids are left to deferred stage.
+ * A thread waits for grp_usb from before the task list is filled, all its members are done when it returns
+ * unless one failed, every group is listed as over at the end.
+ * A hung module sleeps hung_usecs with deadlines of overdue_test msecs, its thread is written off,
+ * everything else goes on and its dependents run when it returns, both stages end when it is done.
+ * Built with CONFIG_ASYNCHRO_MODULE_INIT_RETRY (make ptest-retry) a module failing in asynchronized stage
+ * runs again in deferred one, children of a hung parent still wait for it after failed tasks are reset:
+ *  ptest-retry 1000 sleep 1 none none agp_init
+ * Rows of the table keep their number of workers, the pool does not grow there.
+ * A sleeping initcall is blocked like in msleep, a run with growth on must add threads while it sleeps.
+ * A last run with 4 workers has deferred stage started in background when kernel_init is done,
+ * the write waits for it and initcalls must not take more than the budget share of its time.
+ *
+ *  ptest [usecs [sleep|spin [runs [failing_module [demand [hung_module]]]]]]
+ */
+
+#define TEST
+#define KSTUB_THREADS
+
+#include "linux/async_minit.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "kstub.h"
+
+static unsigned usecs = 1000;           // initcall duration
+static bool spin;                       // busy wait instead of sleep
+unsigned kstub_cpus = 1;
+
+static const struct init_fn_t_4* registered;
+static std::atomic<int> runs[module_last];
+static std::atomic<int> done[module_last];
+static std::atomic<unsigned> errors;
+static modules_e failing = none_id;     // initcall returning an error
+static const char* demand = "sound";    // class or module demanded during asynchronized stage
+static const unsigned demand_major = 10;        // misc char node opened after it
+static modules_e hung = none_id;        // initcall taking much longer than its deadline
+static std::atomic<int> failed_early;   // failing module run in asynchronized stage, retried later
+enum { hung_usecs = 300000, overdue_test = 50, background_test = 50 };
+
+static void CheckParents(modules_e id);
+static bool AsyncStage(void);
+
+static char deferred_code[module_last];     // deferred init memory part
+
+/*
+ * Synthetic initcall, fnc is registration index + 1 or its address in deferred part
+ */
+int do_one_initcall(initcall_t fnc)
+{
+    const char* addr = (const char*) fnc;
+    modules_e id = registered[addr >= deferred_code && addr < deferred_code + module_last ? addr - deferred_code : (uintptr_t) fnc - 1].id;
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::microseconds(usecs);
+    CheckParents(id);
+    ++runs[id];
+    if (spin)
+        while (std::chrono::steady_clock::now() < end)
+            ;
+    else
+    {
+        if (current != NULL)
+            WRITE_ONCE(current->state, TASK_UNINTERRUPTIBLE);
+        std::this_thread::sleep_for(std::chrono::microseconds(id == hung ? hung_usecs : usecs));
+        if (current != NULL)
+            WRITE_ONCE(current->state, TASK_RUNNING);
+    }
+    done[id] = 1;
+    if (id == failing && AsyncStage())
+        ++failed_early;
+    return id == failing ? -19 : 0;
+}
+
+#include "../src/drivers/async.c"
+
+#define INI_FNC(id,...) { id ## _id, 0 },
+static struct init_fn_t_4 list_full[] = { MODULES_ID(INI_FNC) };
+enum { list_count = sizeof(list_full) / sizeof(*list_full) };
+
+static bool AsyncStage(void)
+{
+    return READ_ONCE(current_type) == asynchronized;
+}
+
+static bool Registered(modules_e id)
+{
+    return id != none_id && id != grp_none_id && init_info[id].type != disable;
+}
+
+/*
+ * A parent is done or it is a group with all members done
+ */
+static bool ParentDone(modules_e parent)
+{
+    unsigned id;
+    if (parent == none_id || parent == grp_none_id)
+        return true;
+    if (init_info[parent].type != disable)
+        return done[parent] != 0;
+    for (id = 0; id < module_last; ++id)
+    {
+        if (Registered((modules_e) id) && init_info[id].grp_id == parent && done[id] == 0)
+            return false;
+    }
+    return true;
+}
+
+/*
+ * Module is not executed when any parent failed or was skipped, a group fails with any member
+ */
+static bool Skipped(modules_e id)
+{
+    const struct init_fnc_info_4* nfo = &init_info[id];
+    unsigned idx;
+    if (id == none_id || id == grp_none_id)
+        return false;
+    if (nfo->type == disable)
+    {
+        for (idx = 0; idx < module_last; ++idx)
+        {
+            if (Registered((modules_e) idx) && init_info[idx].grp_id == id && (idx == failing || Skipped((modules_e) idx)))
+                return true;
+        }
+        return false;
+    }
+    for (idx = nfo->parents; idx != nfo->parents + nfo->parents_count; ++idx)
+    {
+        if (init_parents[idx] == failing || Skipped(init_parents[idx]))
+            return true;
+    }
+    return false;
+}
+
+static void CheckParents(modules_e id)
+{
+    const struct init_fnc_info_4* nfo = &init_info[id];
+    unsigned idx;
+    for (idx = nfo->parents; idx != nfo->parents + nfo->parents_count; ++idx)
+    {
+        if (!ParentDone(init_parents[idx]))
+        {
+            printf("error: %s started before %s\n", getName(id), getName(init_parents[idx]));
+            ++errors;
+        }
+    }
+}
+
+/*
+ * Module served by the demand is done unless a parent failed, a group is done with its members
+ */
+static void CheckDemanded(modules_e id)
+{
+    if ((Registered(id) || init_info[id].type == disable) && !Skipped(id) && !ParentDone(id))
+    {
+        printf("error: %s not done on demand\n", getName(id));
+        ++errors;
+    }
+}
+
+/*
+ * Demand runs from another thread as soon as the task list is ready,
+ * every module serving it is done when it returns
+ */
+static void Demanded(void)
+{
+    struct file f = { };
+    unsigned idx;
+    while (atomic_read(&demand_ready) == 0)
+        std::this_thread::yield();
+    // echo name > /proc/deferred_initcalls, it must not keep the deferred stage from being started later
+    if (device_open(NULL, &f) != 0)
+    {
+        printf("error: deferred_initcalls not opened for a demand\n");
+        ++errors;
+    }
+    device_write(&f, demand, strlen(demand), NULL);
+    for (idx = 0; init_devices[idx].id != none_id; ++idx)
+    {
+        if (strcmp(init_devices[idx].name, demand) == 0)
+            CheckDemanded(init_devices[idx].id);
+    }
+    for (idx = 0; idx < module_last; ++idx)
+    {
+        if (strcmp(getName((modules_e) idx), demand) == 0)
+            CheckDemanded((modules_e) idx);
+    }
+    // open of a node of a major owned as a whole, base_probe is not reached for it
+    if (async_minit_demand_dev('c', demand_major) == -ENODEV)
+    {
+        printf("error: nothing known for char major %u\n", demand_major);
+        ++errors;
+    }
+    for (idx = 0; init_devices[idx].id != none_id; ++idx)
+    {
+        if (init_devices[idx].type == 'c' && init_devices[idx].major == demand_major)
+            CheckDemanded(init_devices[idx].id);
+    }
+}
+
+/*
+ * Root file system could be mounted, every critical task is done unless a parent failed
+ */
+static void CriticalWaited(void)
+{
+    unsigned id;
+    wait_for_completion(&critical_done);
+    for (id = 0; id < module_last; ++id)
+    {
+        if (Registered((modules_e) id) && init_info[id].type == critical && !Skipped((modules_e) id)
+                && (modules_e) id != failing && done[id] == 0)
+        {
+            printf("error: %s not done on critical completion\n", getName((modules_e) id));
+            ++errors;
+        }
+    }
+}
+
+/*
+ * Group waited from another thread, its members are done or one failed
+ */
+static void GroupWaited(void)
+{
+    int ret = async_minit_wait_group(grp_usb_id);
+    if ((ret == 0) == Skipped(grp_usb_id) || (ret == 0 && !ParentDone(grp_usb_id)))
+    {
+        printf("error: grp_usb over with %d\n", ret);
+        ++errors;
+    }
+}
+
+/*
+ * Every group is over once both stages are done, grp_usb is done unless a member failed
+ */
+static void CheckGroups(void)
+{
+    struct file f = { };
+    loff_t pos = 0;
+    char text[8192];
+    unsigned len = groups_read(&f, text, sizeof(text) - 1, &pos);
+    text[len] = 0;
+    if (len == 0 || strstr(text, " waiting ") != NULL
+            || (strstr(text, "grp_usb done 0\n") != NULL) == Skipped(grp_usb_id))
+    {
+        printf("error: groups not over\n%s", text);
+        ++errors;
+    }
+}
+
+/*
+ * Working threads of the last stage took distinct online cpus, the last online one is left free
+ */
+static void CheckCpus(void)
+{
+    unsigned idx;
+    unsigned other;
+    for (idx = 0; idx < deques_count; ++idx)
+    {
+        for (other = 0; other < idx && worker_cpu[other] != worker_cpu[idx]; ++other)
+            ;
+        if (worker_cpu[idx] % 2 != 0 || worker_cpu[idx] >= nr_cpu_ids - 2 || other != idx)
+        {
+            printf("error: thread %u on cpu %u\n", idx, worker_cpu[idx]);
+            ++errors;
+        }
+    }
+}
+
+/*
+ * Generic init memory part is released when kernel_init and every task with code there are over
+ */
+static void CheckGenericPart(void)
+{
+    bool over = true;
+    unsigned status;
+    unsigned idx;
+    for (idx = 0; idx < tasks_count; ++idx)
+    {
+        status = atomic_read(&info_4[task_list[idx]->id].status);
+        if ((info_4[task_list[idx]->id].parts & (1 << part_generic)) && (status == st_waiting || status == st_running))
+            over = false;
+    }
+    if (over != (atomic_read(&free_init_ref) == 0))
+    {
+        printf("error: generic init part %s\n", over ? "not released" : "released too early");
+        ++errors;
+    }
+}
+
+/*
+ * Percent of tasks with a parent that were run by the worker of the last parent done
+ */
+static double Locality(void)
+{
+    const struct init_fnc_info_4* nfo;
+    unsigned with_parent = 0;
+    unsigned local = 0;
+    unsigned id;
+    unsigned idx;
+    modules_e last;
+    for (id = 0; id < module_last; ++id)
+    {
+        nfo = &init_info[id];
+        if (!Registered((modules_e) id) || runs[id] == 0)
+            continue;
+        last = none_id;
+        for (idx = nfo->parents; idx != nfo->parents + nfo->parents_count; ++idx)
+        {
+            if (Registered(init_parents[idx]) && (last == none_id || task_time[init_parents[idx]].end > task_time[last].end))
+                last = init_parents[idx];
+        }
+        if (last == none_id)
+            continue;
+        ++with_parent;
+        if (task_time[last].worker == task_time[id].worker)
+            ++local;
+    }
+    return with_parent ? 100.0 * local / with_parent : 0.0;
+}
+
+/*
+ * Another process writes 1 to deferred_initcalls, it only waits for the stage started by the first writer
+ */
+static void SecondWriter(void)
+{
+    struct file f = { };
+    if (device_open(NULL, &f) != 0 || device_write(&f, "1", 1, NULL) != 1)
+    {
+        printf("error: second writer failed\n");
+        ++errors;
+    }
+}
+
+/*
+ * Extra runs of a module, the failing one runs again in deferred stage when retry is built in
+ */
+static int Retried(modules_e id)
+{
+#ifdef CONFIG_ASYNCHRO_MODULE_INIT_RETRY
+    return id == failing && failed_early != 0;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Run both stages with workers threads, return wall time in usecs
+ */
+static unsigned long Run(unsigned workers)
+{
+    std::chrono::steady_clock::time_point start;
+    struct file f = { };
+    char text[64];
+    unsigned id;
+    for (id = 0; id < module_last; ++id)
+    {
+        runs[id] = 0;
+        done[id] = 0;
+    }
+    failed_early = 0;
+    kstub_cpus = workers + 1;     // one cpu is left free
+    memset(task_time, 0, sizeof(task_time));
+    start = std::chrono::steady_clock::now();
+    atomic_set(&deferred_started, 0);
+    atomic_set(&deferred_done, 0);
+    atomic_set(&demand_ready, 0);
+    atomic_set(&free_init_ref, 2);     // kernel_init and async_init
+    atomic_set(&scheduler_ref, 1);
+    kstub_areas_freed = 0;
+    reinit_completion(&critical_done);
+    std::thread group(GroupWaited);
+    std::thread async(do_asynchronized, (void*) NULL);
+    if (demand != NULL)
+        Demanded();
+    CriticalWaited();
+    async_minit_release_init();         // kernel_init is done
+    async_minit_background();
+    async.join();
+    CheckGenericPart();
+    std::thread writer(SecondWriter);
+    if (device_open(NULL, &f) != 0 || device_write(&f, "1", 1, NULL) != 1)
+    {
+        printf("error: deferred stage not started\n");
+        ++errors;
+    }
+    writer.join();
+    // deferred stage threads may be gone before the hung task returns and finishes it,
+    // a background stage is finished by its own thread after the write is done waiting
+    for (id = 0; (hung != none_id || background_budget != 0) && (READ_ONCE(current_type) != end
+            || atomic_read(&scheduler_ref) != 0) && id < 2 * hung_usecs / 1000; ++id)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (READ_ONCE(current_type) != end)
+    {
+        printf("error: deferred stage not done\n");
+        ++errors;
+    }
+    if (background_budget != 0 && (u64) atomic_read(&background_busy) * 100
+            > (local_clock() - background_start) / 1000 * background_budget + background_period * 1000 * 100)
+    {
+        printf("error: background stage over its budget, %d usecs\n", atomic_read(&background_busy));
+        ++errors;
+    }
+    group.join();
+    CheckGroups();
+    CheckCpus();
+    f = { };
+    if (device_open(NULL, &f) != 0 || device_read(&f, text, sizeof(text), NULL) != 0)
+    {
+        printf("error: deferred_initcalls not at end of file\n");
+        ++errors;
+    }
+    if (atomic_read(&free_init_ref) != 0 || atomic_read(&deferred_left) != 0 || atomic_read(&scheduler_ref) != 0
+            || kstub_areas_freed != 6)     // generic part has 3 ranges, deferred part 1 and scheduler part 2
+    {
+        printf("error: init memory not released, %u areas\n", (unsigned) kstub_areas_freed);
+        ++errors;
+    }
+    for (id = 0; id < module_last; ++id)
+    {
+        if (Registered((modules_e) id) && runs[id] != (Skipped((modules_e) id) ? 0 : 1) + Retried((modules_e) id))
+        {
+            printf("error: %s run %d times\n", getName((modules_e) id), (int) runs[id]);
+            ++errors;
+        }
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    static const unsigned workers[] = { 1, 2, 4, 8, 16 };
+    unsigned repeat = 1;
+    unsigned tasks = 0;
+    unsigned long serial = 0;
+    unsigned long wall;
+    unsigned idx;
+    unsigned it;
+    if (argc > 1)
+        usecs = strtoul(argv[1], NULL, 10);
+    if (argc > 2)
+        spin = strcmp(argv[2], "spin") == 0;
+    if (argc > 3)
+        repeat = strtoul(argv[3], NULL, 10);
+    for (idx = 0; argc > 4 && idx < module_last; ++idx)
+    {
+        if (strcmp(argv[4], getName((modules_e) idx)) == 0)
+            failing = (modules_e) idx;
+    }
+    for (idx = 0; idx < list_count; ++idx)
+    {
+        if (init_info[list_full[idx].id].type == deferred)
+            list_full[idx].fnc = (initcall_t) (deferred_code + idx);
+        else
+            list_full[idx].fnc = (initcall_t) (uintptr_t) (idx + 1);
+        if (Registered(list_full[idx].id))
+            ++tasks;
+    }
+    if (argc > 5)
+        demand = strcmp(argv[5], "none") != 0 ? argv[5] : NULL;
+    for (idx = 0; argc > 6 && idx < module_last; ++idx)
+    {
+        if (strcmp(argv[6], getName((modules_e) idx)) == 0)
+            hung = (modules_e) idx;
+    }
+    if (hung != none_id)
+    {
+        for (idx = 0; idx < sizeof(overdue_msecs) / sizeof(*overdue_msecs); ++idx)
+            overdue_msecs[idx] = overdue_test;
+    }
+    registered = list_full;
+    __deferred_text_begin = deferred_code;
+    __deferred_text_end = deferred_code + module_last;
+    __async_initcall_start = list_full;
+    __async_initcall_end = list_full + list_count;
+    printf("%u initcalls of %u usecs %s\n", tasks, usecs, spin ? "spinning" : "sleeping");
+    pool_grow = 0;
+    for (idx = 0; idx < sizeof(workers) / sizeof(*workers); ++idx)
+    {
+        for (it = 0; it < repeat; ++it)
+        {
+            wall = Run(workers[idx]);
+            if (workers[idx] == 1 && it == 0)
+                serial = wall;
+            printf("%2u workers: %8lu usecs %8.1f initcalls/s speedup %.2f locality %.0f%% overdue %d\n", workers[idx], wall,
+                    wall ? tasks * 1e6 / wall : 0.0, wall ? (double) serial / wall : 0.0, Locality(),
+                    atomic_read(&tasks_overdue));
+            if (atomic_read(&workers_added) != 0)
+            {
+                printf("error: %d threads added with growth off\n", atomic_read(&workers_added));
+                ++errors;
+            }
+            atomic_set(&tasks_overdue, 0);
+        }
+    }
+    // one worker sleeping in its initcalls leaves the cpus idle, the watchdog adds a thread
+    pool_grow = 1;
+    wall = Run(1);
+    printf("growth: %8lu usecs from 1 worker, added %d\n", wall, atomic_read(&workers_added));
+    if (!spin && hung == none_id && wall > 4 * watch_period * 1000 && atomic_read(&workers_added) == 0)
+    {
+        printf("error: pool did not grow\n");
+        ++errors;
+    }
+    atomic_set(&tasks_overdue, 0);
+    atomic_set(&workers_added, 0);
+    background_budget = background_test;
+    wall = Run(4);
+    printf("background: %8lu usecs at %u%% of a cpu, %d usecs in initcalls\n", wall, background_budget,
+            atomic_read(&background_busy));
+    if (errors != 0)
+    {
+        printf("%u errors\n", (unsigned) errors);
+        return 1;
+    }
+    printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,329 @@
+/*
+ * simulate.cpp
+ *
+ * Replay initcall_debug timings against async module dependencies.
+ * Trace lines "initcall X+0x0/0x.. returned R after N usecs" give the cost of every module,
+ * scheduling is done by async.c code itself on simulated working threads.
+ *
+ *  simulate initcall_list.txt [max_workers [lspci_dump|- [boot_parameters]]]
+ *
+ * For every worker count it reports makespan, utilization and idle gaps of both stages,
+ * deferred stage is run on the same workers after asynchronized one.
+ * A gap is a worker waiting for dependencies before taking its next task, idle time also counts
+ * workers with nothing left to do at the end of the stage.
+ * The critical path does not depend on workers and it is the lower bound of any schedule.
+ * Root ready is the time of asynchronized stage when all critical tasks are over.
+ * With an lspci -nn -v dump only its PCI devices are present, drivers without them are left to deferred stage.
+ * The trace is given to async.c as the profile of last boot, costs and -ENODEV returns seed the schedule
+ * and the profile sets the workers worth running.
+ * Boot parameters are async_minit.defer= .. as on the kernel command line, one string separated by spaces
+ */
+
+#define TEST
+
+#include "linux/async_minit.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <map>
+
+#include "kstub.h"
+
+int do_one_initcall(initcall_t fnc)
+{
+    return 0;
+}
+
+#include "../src/drivers/async.c"
+
+static std::vector<init_fn_t_4> registered;       // traced initcalls known by async
+static unsigned long cost[module_last];           // usecs, all instances of an id
+static int ret[module_last];                      // last return code of an id
+static std::string profile;                       // "name usecs ret" records of the trace
+
+/*
+ * Read trace, modules without id are not handled by async and they are skipped
+ */
+static bool LoadTrace(const char* file_name)
+{
+    std::map<std::string, modules_e> ids;
+    std::ifstream file(file_name);
+    std::string line;
+    std::string name;
+    size_t pos;
+    size_t end;
+    unsigned skipped = 0;
+    if (!file)
+        return false;
+    for (unsigned id = 0; id < module_last; ++id)
+        ids[getName((modules_e) id)] = (modules_e) id;
+    while (std::getline(file, line))
+    {
+        pos = line.find("initcall ");
+        if (pos == std::string::npos || line.find(" returned ") == std::string::npos)
+            continue;
+        pos += strlen("initcall ");
+        end = line.find_first_of("+ ", pos);
+        name = line.substr(pos, end - pos);
+        pos = line.find(" after ");
+        if (pos == std::string::npos)
+            continue;
+        auto it = ids.find(name);
+        if (it == ids.end())
+        {
+            ++skipped;
+            continue;
+        }
+        cost[it->second] += strtoul(line.c_str() + pos + strlen(" after "), NULL, 10);
+        ret[it->second] = strtol(line.c_str() + line.find(" returned ") + strlen(" returned "), NULL, 10);
+        registered.push_back( { it->second, (initcall_t) (registered.size() + 1) });
+    }
+    for (unsigned id = 0; id < module_last; ++id)
+    {
+        if (cost[id] != 0 || ret[id] != 0)
+            profile += std::string(getName((modules_e) id)) + " " + std::to_string(cost[id]) + " " + std::to_string(ret[id]) + "\n";
+    }
+    printf("%s: %zu async initcalls, %u not async\n", file_name, registered.size(), skipped);
+    return true;
+}
+
+/*
+ * Read present PCI devices from lspci -nn, device lines are "slot name [class]: name [vendor:device] (prog-if xx"
+ */
+static bool LoadPci(const char* file_name)
+{
+    std::ifstream file(file_name);
+    std::string line;
+    size_t pos;
+    unsigned cls;
+    unsigned vendor;
+    unsigned device;
+    unsigned prog_if;
+    if (!file)
+        return false;
+    while (std::getline(file, line) && kstub_pci_count < kstub_pci_max)
+    {
+        if (line.empty() || isspace(line[0]) || sscanf(line.c_str() + line.find(" ["), " [%4x]", &cls) != 1)
+            continue;
+        for (pos = line.find('['); pos != std::string::npos; pos = line.find('[', pos + 1))
+        {
+            if (sscanf(line.c_str() + pos, "[%4x:%4x]", &vendor, &device) == 2)
+                break;
+        }
+        if (pos == std::string::npos)
+            continue;
+        pos = line.find("(prog-if ");
+        if (pos == std::string::npos || sscanf(line.c_str() + pos, "(prog-if %2x", &prog_if) != 1)
+            prog_if = 0;
+        kstub_pci_devs[kstub_pci_count].vendor = vendor;
+        kstub_pci_devs[kstub_pci_count].device = device;
+        kstub_pci_devs[kstub_pci_count].class = cls << 8 | prog_if;
+        ++kstub_pci_count;
+    }
+    printf("%s: %u PCI devices\n", file_name, kstub_pci_count);
+    return true;
+}
+
+/*
+ * Split "async_minit.x=value ..." and hand values to the boot parameter setup of async.c
+ */
+static void BootParameters(char* text)
+{
+    static const struct { const char* name; int (*setup)(char*); } params[] = {
+        { "async_minit.async=", asynchronized_setup }, { "async_minit.defer=", deferred_setup },
+        { "async_minit.critical=", critical_setup }, { "async_minit.disable=", disable_setup },
+        { "async_minit.prio=", PrioSetup }, { "async_minit.threads=", ThreadsSetup },
+        { "async_minit.profile=", ProfileSetup } };
+    char* param;
+    for (param = strtok(text, " "); param != NULL; param = strtok(NULL, " "))
+    {
+        for (auto& it : params)
+        {
+            if (strncmp(param, it.name, strlen(it.name)) == 0)
+                it.setup(param + strlen(it.name));
+        }
+    }
+}
+
+/*
+ * Longest path in usecs from id to the end of its chain, next gets the child on that path
+ */
+static unsigned long CriticalPath(modules_e id, modules_e* next)
+{
+    unsigned long path = 0;
+    unsigned long child;
+    modules_e ignore;
+    *next = none_id;
+    for (unsigned idx = child_first[id]; idx != child_first[id + 1]; ++idx)
+    {
+        child = CriticalPath(child_list[idx], &ignore);
+        if (child > path || *next == none_id)
+        {
+            path = child;
+            *next = child_list[idx];
+        }
+    }
+    return path + cost[id];
+}
+
+struct stage_result_t
+{
+    unsigned long makespan;
+    unsigned long busy;         // sum of all task costs run
+    unsigned long gaps;         // times a worker went idle with tasks still to run
+    unsigned long longest_gap;
+    unsigned long critical;     // last critical task done
+    unsigned tasks;
+};
+
+/*
+ * Run a stage with workers threads, time is usecs from stage start
+ */
+static stage_result_t SimulateStage(enum task_type_t type, unsigned workers)
+{
+    stage_result_t result = { };
+    std::vector<const init_fn_t_4*> running(workers);
+    std::vector<unsigned long> end(workers);
+    std::vector<unsigned long> idle_from(workers);
+    unsigned long now = 0;
+    unsigned gen;
+    unsigned worker;
+    unsigned busy;
+    current_type = type;
+    stage_done = 0;
+    atomic_set(&threads_active, 0);
+    InitDeques(workers);
+    for (;;)
+    {
+        // idle workers take ready tasks by priority
+        busy = 0;
+        for (worker = 0; worker < workers; ++worker)
+        {
+            if (running[worker] == NULL)
+            {
+                atomic_inc(&threads_active);
+                running[worker] = PeekTask(worker, &gen);
+                if (running[worker] != NULL)
+                {
+                    task_time[running[worker]->id].worker = worker;
+                    if (now > idle_from[worker])
+                    {
+                        ++result.gaps;
+                        if (now - idle_from[worker] > result.longest_gap)
+                            result.longest_gap = now - idle_from[worker];
+                    }
+                    end[worker] = now + cost[running[worker]->id];
+                    result.busy += cost[running[worker]->id];
+                    ++result.tasks;
+                }
+            }
+            if (running[worker] != NULL)
+                ++busy;
+        }
+        if (busy == 0)
+            break;
+        // first task to finish
+        worker = workers;
+        for (unsigned it = 0; it < workers; ++it)
+        {
+            if (running[it] != NULL && (worker == workers || end[it] < end[worker]))
+                worker = it;
+        }
+        now = end[worker];
+        TaskDone(running[worker], 0);
+        if (init_info[running[worker]->id].type == critical)
+            result.critical = now;
+        running[worker] = NULL;
+        idle_from[worker] = now;
+    }
+    result.makespan = now;
+    return result;
+}
+
+static void PrintStage(const char* name, const stage_result_t& stage, unsigned workers)
+{
+    printf("  %-8s %4u tasks makespan %9lu usecs utilization %5.1f%% idle %9lu usecs gaps %3lu longest %9lu\n",
+            name, stage.tasks, stage.makespan,
+            stage.makespan ? 100.0 * stage.busy / ((double) stage.makespan * workers) : 100.0,
+            stage.makespan * workers - stage.busy, stage.gaps, stage.longest_gap);
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned max_workers = 8;
+    unsigned long path;
+    unsigned long longest = 0;
+    unsigned long total = 0;
+    unsigned absent = 0;
+    modules_e first = none_id;
+    modules_e next;
+    if (argc < 2)
+    {
+        printf("usage: %s initcall_trace [max_workers [lspci_dump|- [boot_parameters]]]\n", argv[0]);
+        return 1;
+    }
+    if (argc > 2)
+        max_workers = strtoul(argv[2], NULL, 10);
+    if (!LoadTrace(argv[1]))
+    {
+        printf("can not read %s\n", argv[1]);
+        return 1;
+    }
+    if (argc > 3 && strcmp(argv[3], "-") != 0 && !LoadPci(argv[3]))
+    {
+        printf("can not read %s\n", argv[3]);
+        return 1;
+    }
+    pci_prune = kstub_pci_count != 0 ? prune_defer : prune_none;
+    if (registered.empty())
+        return 0;
+    profile_cmdline = &profile[0];
+    if (argc > 4)
+        BootParameters(argv[4]);
+    FillTasks(&registered.front(), &registered.front() + registered.size());
+    printf("profile: %u records, %u workers worth running\n", profile_records, profile_threads);
+    for (unsigned idx = 0; idx < tasks_count; ++idx)
+    {
+        if (info_4[task_list[idx]->id].absent)
+        {
+            printf("no PCI device for %s\n", getName(task_list[idx]->id));
+            ++absent;
+        }
+        total += cost[task_list[idx]->id];
+        path = CriticalPath(task_list[idx]->id, &next);
+        if (path > longest || first == none_id)
+        {
+            longest = path;
+            first = task_list[idx]->id;
+        }
+    }
+    printf("total %lu usecs, critical path %lu usecs:", total, longest);
+    for (; first != none_id; first = next)
+    {
+        CriticalPath(first, &next);
+        if (init_info[first].type != disable)
+            printf(" %s(%lu)", getName(first), cost[first]);
+    }
+    printf("\n");
+    if (kstub_pci_count != 0)
+        printf("%u initcalls without PCI device left to deferred stage\n", absent);
+    for (unsigned workers = 1; workers <= max_workers; ++workers)
+    {
+        FillTasks(&registered.front(), &registered.front() + registered.size());
+        stage_result_t async_stage = SimulateStage(asynchronized, workers);
+        stage_result_t deferred_stage = SimulateStage(deferred, workers);
+        printf("%u workers: makespan %lu usecs, speedup %.2f\n", workers,
+                async_stage.makespan + deferred_stage.makespan,
+                (async_stage.makespan + deferred_stage.makespan) ? (double) total / (async_stage.makespan + deferred_stage.makespan) : 1.0);
+        printf("  root ready %lu usecs\n", async_stage.critical);
+        PrintStage("async", async_stage, workers);
+        PrintStage("deferred", deferred_stage, workers);
+    }
+    return 0;
+}